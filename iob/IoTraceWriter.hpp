@@ -0,0 +1,91 @@
+#pragma once
+
+#include "IoTraceFormat.hpp"
+#include "RequestGenerator.hpp"
+#include "ThreadBase.hpp"
+#include "Time.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mean {
+
+// Streams the per-I/O trace (--iotrace) to iob-trace-<prefix>.bin while the run goes on: the generators push one
+// fixed-size record per completion into their ring, this thread drains the rings into delta/varint encoded chunks.
+// A full ring drops records (counted in the next chunk) instead of stalling the generator.
+class IoTraceWriter : public ThreadBase {
+   static constexpr uint32_t chunkRecords = 4096;
+   std::vector<RequestGenerator*> gens;
+   std::vector<uint64_t> dropped; // overruns already written, per generator
+   std::ofstream file;
+   iobtrace::ChunkEncoder encoder;
+   uint64_t records = 0;
+   uint64_t bytes = 0;
+
+   // one chunk per generator and round, false: all rings were empty
+   bool drain() {
+      bool any = false;
+      iobtrace::Record r;
+      for (size_t i = 0; i < gens.size(); i++) {
+         auto& ring = *gens[i]->ioTrace;
+         if (!ring.pop(r)) {
+            continue;
+         }
+         const uint64_t overruns = ring.overrunCount();
+         encoder.begin(gens[i]->genId, overruns - dropped[i], r.end);
+         dropped[i] = overruns;
+         do {
+            encoder.add(r);
+         } while (encoder.header.records < chunkRecords && ring.pop(r));
+         encoder.finish();
+         file.write((const char*)&encoder.header, sizeof(encoder.header));
+         file.write(encoder.data.data(), encoder.data.size());
+         records += encoder.header.records;
+         bytes += sizeof(encoder.header) + encoder.data.size();
+         any = true;
+      }
+      return any;
+   }
+
+ public:
+   IoTraceWriter(const JobOptions& options, std::vector<RequestGenerator*> gens) : ThreadBase("iotrace", 0), gens(std::move(gens)), dropped(this->gens.size()) {
+      std::string name = "iob-trace-" + options.statsPrefix + ".bin";
+      file.open(name, std::ios::binary | std::ios::trunc);
+      ensurem(file.good(), "could not open " + name);
+      iobtrace::FileHeader header;
+      header.bs = options.bs;
+      header.tscPerNs = tscPerNs;
+      header.startTsc = readTSC();
+      file.write((const char*)&header, sizeof(header));
+      encoder.data.reserve(chunkRecords * 24);
+   }
+   ~IoTraceWriter() override {
+      stop();
+      join();
+   }
+
+   int process() override {
+      while (keepRunning()) {
+         if (!drain()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+         }
+      }
+      // the generators are done
+      while (drain()) {
+      }
+      file.flush();
+      uint64_t lost = 0;
+      for (auto* g: gens) {
+         lost += g->ioTrace->overrunCount();
+      }
+      std::cout << "iotrace: " << records << " I/Os " << (records ? bytes / (double)records : 0) << " bytes/io";
+      std::cout << (lost ? ", dropped " + std::to_string(lost) + " (ring full)" : "") << std::endl;
+      return 0;
+   }
+};
+
+} // namespace mean
@@ -2,7 +2,10 @@
 
 #include "PatternGen.hpp"
 
+#include "IoTraceFormat.hpp"
+#include "LogHist.hpp"
 #include "PageState.hpp"
+#include "SpscRing.hpp"
 #include "Time.hpp"
 #include "Units.hpp"
 #include "io/IoInterface.hpp"
@@ -22,9 +25,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <pthread.h>
 #include <random>
 #include <sched.h>
@@ -58,6 +63,7 @@ struct JobOptions {
    float rateLimit = 0;
    float totalRate = 0;
    bool exponentialRate = true;
+   bool openLoop = false; // with rateLimit: latency from the intended issue time, late arrivals are kept
    int threads = 1;
    bool printEverySecond = false;
    string logHash;
@@ -83,6 +89,8 @@ struct JobOptions {
 
    bool longConsoleOutput = false;
 
+   long smartIntervalMs = 1000;
+
    // Stats options
    bool enableIoTracing = false;
    bool enableLatenyTracking = true;
@@ -122,14 +130,30 @@ struct JobOptions {
    }
 };
 
+// one line of a per-thread stats csv: taken by the generator, formatted and written by the StatsLogger thread
+struct StatsRecord {
+   static constexpr int histCount = 6;
+   static constexpr const char* histNames[histCount] = {"r", "w", "s", "c", "rr", "wr"};
+
+   uint64_t localTime = 0;
+   float timeDiff = 0;
+   long writes = 0;
+   long reads = 0;
+   unsigned long fdatasyncs = 0;
+   u64 missedSchedule = 0;
+   float threadRate = 0; // current rate of the generator, changed by --sweep
+   LogHist::Summary hists[histCount];
+};
+
 struct JobStats {
    const u64 bs;
 
    float time;                    // s
-   long readTotalTime = 0;        // us
+   double cpuTime = 0;            // s, cpu time of the generator thread (submission and completion)
+   long readTotalTime = 0;        // ns
    long readHghPrioTotalTime = 0; // High priority reads not used
-   long writeTotalTime = 0;       // us
-   long fdatasyncTotalTime = 0;   // us
+   long writeTotalTime = 0;       // ns
+   long fdatasyncTotalTime = 0;   // ns
 
    atomic<unsigned long> reads = 0;
    unsigned long readsHighPrio = 0;
@@ -146,20 +170,24 @@ struct JobStats {
    static const int maxSeconds = 24 * 60 * 60; // 1 day in seconds
    std::atomic<int> seconds = 0;
 
-   static const int histBuckets = 20000;
-   static const int histFrom = 0;
-   static const int histTo = 19999;
+   // latencies in ns, written in us
+   LogHist readHist;
+   LogHist readHpHist;
+   LogHist writeHist;
+   LogHist fdatasyncHist;
 
-   Hist<int, int> readHist{histBuckets, histFrom, histTo};
-   Hist<int, int> readHpHist{histBuckets, histFrom, histTo};
-   Hist<int, int> writeHist{histBuckets, histFrom, histTo};
-   Hist<int, int> fdatasyncHist{histBuckets, histFrom, histTo};
+   LogHist readHistEverySecond;
+   LogHist writeHistEverySecond;
+   LogHist fdatasyncHistEverySecond;
 
-   Hist<int, int> readHistEverySecond{histBuckets, histFrom, histTo};
-   Hist<int, int> writeHistEverySecond{histBuckets, histFrom, histTo};
-   Hist<int, int> fdatasyncHistEverySecond{histBuckets, histFrom, histTo};
+   LogHist cycleHistEverySecond;
 
-   Hist<int, int> cycleHistEverySecond{histBuckets, histFrom, histTo};
+   // open loop: from the intended issue time, includes the time waiting for a free request
+   LogHist readResponseHist;
+   LogHist writeResponseHist;
+   LogHist readResponseHistEverySecond;
+   LogHist writeResponseHistEverySecond;
+   std::atomic<u64> missedSchedule = 0; // arrivals that were due while all iodepth requests were in flight
 
    JobStats(u64 bs) : bs(bs), iopsPerSecond(maxSeconds), readsPerSecond(maxSeconds), writesPerSecond(maxSeconds) {
       assert(iopsPerSecond.size() == maxSeconds);
@@ -167,103 +195,62 @@ struct JobStats {
    JobStats(const JobStats&) = delete;
    JobStats& operator=(const JobStats&) = delete;
 
-   void printStats(std::string& result, const JobOptions& options, uint64_t localTime, uint64_t lastPrintTime, float timeDiff, bool statsFileExists, int genId, std::string patternString, std::string patternDetails) {
-      if (!statsFileExists && lastPrintTime == 0) {
-         result = "hash,prefix,id,time,timeDiff,device,filesizeGib,pattern,patternDetails,rate,threadRate,threadStatsInterval,expRate,writePercent,writeMibs,readMibs,writes,reads,fdatasyncs";
-         result += ",r,";
-         readHistEverySecond.writePercentilesHeader("r", result);
-         result += ",w,";
-         writeHistEverySecond.writePercentilesHeader("w", result);
-         result += ",s,";
-         fdatasyncHistEverySecond.writePercentilesHeader("s", result);
-         result += ",c,";
-         cycleHistEverySecond.writePercentilesHeader("c", result);
-         result += "\n";
+   // generator thread: the numbers of one stats interval, no formatting
+   void takeSnapshot(StatsRecord& rec, uint64_t localTime, uint64_t lastPrintTime, float timeDiff) {
+      rec.localTime = localTime;
+      rec.timeDiff = timeDiff;
+      rec.writes = std::reduce(writesPerSecond.begin() + lastPrintTime, writesPerSecond.begin() + localTime);
+      rec.reads = std::reduce(readsPerSecond.begin() + lastPrintTime, readsPerSecond.begin() + localTime);
+      rec.fdatasyncs = fdatasyncs - lastFdatasync;
+      rec.missedSchedule = missedSchedule.load();
+      LogHist* hists[] = {&readHistEverySecond, &writeHistEverySecond, &fdatasyncHistEverySecond, &cycleHistEverySecond, &readResponseHistEverySecond, &writeResponseHistEverySecond};
+      for (int i = 0; i < StatsRecord::histCount; i++) {
+         rec.hists[i] = hists[i]->summary();
+         hists[i]->resetData();
       }
+      lastFdatasync = fdatasyncs;
+   }
+
+   static void printStatsHeader(std::string& result) {
+      result = "hash,prefix,id,time,timeDiff,device,filesizeGib,pattern,patternDetails,rate,threadRate,threadStatsInterval,expRate,writePercent,writeMibs,readMibs,writes,reads,fdatasyncs";
+      for (const char* name: StatsRecord::histNames) {
+         result += std::string(",") + name + ",";
+         LogHist::writePercentilesHeader(name, result);
+      }
+      result += ",missed";
+   }
 
+   // stats logger thread: one csv line
+   static void printStats(std::string& result, const StatsRecord& rec, const JobOptions& options, int genId, const std::string& patternString, const std::string& patternDetails) {
       // constants
       result += options.logHash;
       result += "," + options.statsPrefix;
       result += "," + std::to_string(genId);
-      result += "," + std::to_string(localTime);
-      result += "," + std::to_string(timeDiff);
+      result += "," + std::to_string(rec.localTime);
+      result += "," + std::to_string(rec.timeDiff);
       result += "," + options.filename;
       result += "," + std::to_string(options.filesize / GIBI);
       result += "," + patternString;
       result += ",\"" + patternDetails + "\"";
       result += "," + std::to_string(options.totalRate);
-      result += "," + std::to_string(options.rateLimit);
+      result += "," + std::to_string(rec.threadRate);
       result += "," + std::to_string(options.threadStatsInterval);
       result += "," + std::to_string(options.exponentialRate);
       result += "," + std::to_string(options.writePercent);
 
       // per seconds
-      auto w = std::reduce(writesPerSecond.begin() + lastPrintTime, writesPerSecond.begin() + localTime);
-      auto r = std::reduce(readsPerSecond.begin() + lastPrintTime, readsPerSecond.begin() + localTime);
-      result += "," + std::to_string((double)w * options.bs / MEBI / timeDiff);
-      result += "," + std::to_string((double)r * options.bs / MEBI / timeDiff);
-      result += "," + std::to_string(w / timeDiff);
-      result += "," + std::to_string(r / timeDiff);
-      result += "," + std::to_string((fdatasyncs - lastFdatasync) / timeDiff);
+      result += "," + std::to_string((double)rec.writes * options.bs / MEBI / rec.timeDiff);
+      result += "," + std::to_string((double)rec.reads * options.bs / MEBI / rec.timeDiff);
+      result += "," + std::to_string(rec.writes / rec.timeDiff);
+      result += "," + std::to_string(rec.reads / rec.timeDiff);
+      result += "," + std::to_string(rec.fdatasyncs / rec.timeDiff);
 
       // hists
-      result += ",r,";
-      readHistEverySecond.writePercentiles(result);
-      result += ",w,";
-      writeHistEverySecond.writePercentiles(result);
-      result += ",s,";
-      fdatasyncHistEverySecond.writePercentiles(result);
-      result += ",c,";
-      cycleHistEverySecond.writePercentiles(result);
-
-      // reset hists
-      readHistEverySecond.resetData();
-      writeHistEverySecond.resetData();
-      fdatasyncHistEverySecond.resetData();
-      cycleHistEverySecond.resetData();
-
-      lastFdatasync = fdatasyncs;
-   }
-};
-
-struct IoTrace {
-   struct IoStat {
-      int threadId;
-      int reqId;
-      uint64_t begin;
-      uint64_t submit;
-      uint64_t end;
-      u64 addr;
-      u32 len;
-      IoRequestType type;
-
-      static void dumpIoStatHeader(std::ostream& out, std::string prefix) {
-         out << prefix << "threadid,reqId,type, begin, submit, end, addr, len";
-      }
-      void dumpIoStat(std::string prefix, std::ostream& out) const {
-         out << prefix << threadId << "," << reqId << "," << (int)type << "," << nanoFromTsc(begin) << "," << nanoFromTsc(submit) << "," << nanoFromTsc(end) << "," << addr << "," << len;
-      }
-   };
-   std::vector<IoStat> ioTrace;
-   bool ioTracing = false;
-   uint64_t evaluatedtIos = 0;
-
-   void setIoTracing(bool enable) {
-      ioTracing = enable;
-      if (enable) {
-         ioTrace.resize(10000000);
-      }
-   }
-
-   static void dumpIoTreaceHeader(std::ostream& out, std::string prefix) {
-      IoStat::dumpIoStatHeader(out, prefix);
-      out << std::endl;
-   }
-   void dumpIoTrace(std::ostream& out, std::string prefix = "") {
-      for (uint64_t i = 0; i < evaluatedtIos; i++) {
-         ioTrace[i].dumpIoStat(prefix, out);
-         out << std::endl;
+      for (int i = 0; i < StatsRecord::histCount; i++) {
+         result += std::string(",") + StatsRecord::histNames[i] + ",";
+         rec.hists[i].writePercentiles(result, KILO);
       }
+      result += "," + std::to_string(rec.missedSchedule);
    }
 };
 
@@ -274,7 +261,9 @@ class RequestGenerator {
    const JobOptions options;
    iob::PatternGen& patternGen;
    FileState& fileState;
-   IoTrace ioTrace;
+   // --iotrace: one record per completion, drained by the IoTraceWriter
+   static constexpr uint64_t ioTraceCapacity = 1 << 18;
+   std::unique_ptr<SpscRing<iobtrace::Record>> ioTrace;
 
    JobStats stats;
 
@@ -299,6 +288,7 @@ class RequestGenerator {
 
    std::vector<u64> availableReqStack;
    int availableReqStackCnt = 0;
+   std::vector<u64> intendedTime; // per request id, tsc, 0: closed loop
 
    unsigned long bss = options.totalMinusOffsetBlocks() / options.threads;
    std::uniform_int_distribution<unsigned long> rbs_dist{0, bss};
@@ -306,10 +296,15 @@ class RequestGenerator {
 
    std::random_device randDevice;
    std::mt19937_64 gen{randDevice()};
-   std::exponential_distribution<> rateLimitExpDist;
+   std::exponential_distribution<> rateLimitExpDist; // mean 1, scaled by the rate
+
+   // options.rateLimit and options.iodepth, changed while running by --sweep
+   std::atomic<float> rate;
+   std::atomic<int> depth;
 
-   std::ofstream statsFile;
-   bool statsFileExists = false;
+   // stats lines for the StatsLogger, the hot loop never formats or writes them
+   SpscRing<StatsRecord> statsRing{64};
+   StatsRecord statsRecord;
 
    RequestGenerator(const RequestGenerator& other) = delete;
    RequestGenerator(RequestGenerator&& other) = delete;
@@ -317,8 +312,10 @@ class RequestGenerator {
    RequestGenerator& operator=(RequestGenerator&& other) = delete;
 
    RequestGenerator(std::string name, JobOptions& options, IoChannel& ioChannel, int genId, atomic<long>& time, iob::PatternGen& patternGen, FileState& fileState)
-       : name(std::move(name)), genId(genId), options(options), patternGen(patternGen), fileState(fileState), stats(options.bs), ioChannel(ioChannel), time(time), availableReqStack(options.iodepth), rateLimitExpDist(options.rateLimit) {
-      ioTrace.setIoTracing(options.enableIoTracing);
+       : name(std::move(name)), genId(genId), options(options), patternGen(patternGen), fileState(fileState), stats(options.bs), ioChannel(ioChannel), time(time), availableReqStack(options.iodepth), intendedTime(options.iodepth), rate(options.rateLimit), depth(options.iodepth) {
+      if (options.enableIoTracing) {
+         ioTrace = std::make_unique<SpscRing<iobtrace::Record>>(ioTraceCapacity);
+      }
       readData = std::make_unique<char*[]>(options.iodepth);
       writeData = std::make_unique<char*[]>(options.iodepth);
 
@@ -329,24 +326,17 @@ class RequestGenerator {
       // wd = (char*)IoInterface::allocIoMemoryChecked(((options.iodepth + align)*options.bs) + 512, 512);
       //  WELL, seems like it is slower when not aligned to 4K
       wd = (char*)IoInterface::allocIoMemoryChecked(((options.iodepth + align) * options.bs), 512);
-      std::vector<std::pair<void*, uint64_t>> iovec;
       for (int i = 0; i < options.iodepth; i++) {
          readData[i] = rd + ((align + options.bs) * i) + 0;  //(char*) IoInterface::allocIoMemoryChecked(options.bs, 1);
          writeData[i] = wd + ((align + options.bs) * i) + 0; // (char*) IoInterface::allocIoMemoryChecked(options.bs, 1);
          memset(writeData[i], 'B', options.bs);
          memset(readData[i], 'A', options.bs);
-         iovec.emplace_back(std::pair(readData[i], options.bs));
-         iovec.emplace_back(std::pair(writeData[i], options.bs));
          availableReqStack[i] = i;
       }
       availableReqStackCnt = options.iodepth;
-      std::string statsFileName = "iob-stats-id" + to_string(genId) + "-" + options.statsPrefix + ".csv";
-      {
-         std::ifstream fileExists(statsFileName);
-         statsFileExists = fileExists.good();
-      }
-      statsFile.open(statsFileName, std::ios_base::app);
-      // ioChannel.registerBuffers(iovec);
+      // both arenas once, requests address the slots within them (io_uring fixed buffers, --ioufixed)
+      std::vector<std::pair<void*, uint64_t>> arenas{{rd, (u64)options.iodepth * options.bs}, {wd, (u64)options.iodepth * options.bs}};
+      ioChannel.registerBuffers(arenas);
    }
 
    ~RequestGenerator() {
@@ -374,9 +364,22 @@ class RequestGenerator {
    }
    */
 
+   static double threadCpuSeconds() {
+      timespec ts;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+      return ts.tv_sec + ts.tv_nsec / 1e9;
+   }
+
    void stopIo() {
       keep_running = false;
    }
+   void setRate(float perThread) {
+      rate = perThread;
+   }
+   void setDepth(int d) {
+      ensurem(d >= 1 && d <= options.iodepth, "iodepth " + std::to_string(d) + " outside of [1, " + std::to_string(options.iodepth) + "]");
+      depth = d;
+   }
 
    int runIo() {
       uint64_t countGets = 0;
@@ -384,6 +387,7 @@ class RequestGenerator {
 
       getSeconds();
       auto start = getSeconds();
+      auto cpuStart = threadCpuSeconds();
 
       int64_t completed = 0;
       long polled = 0;
@@ -405,29 +409,44 @@ class RequestGenerator {
       long lastReads = 0;
       long lastWrites = 0;
 
-      std::string statsStr;
-      statsStr.reserve(2048);
-
       auto lastPrintTimeClock = getSeconds();
       auto nextStartTime = mean::readTSC();
+      u64 blockedAt = 0; // open loop: last time an arrival was due and no request was free
+      float scheduledRate = rate.load(); // rate of the schedule from nextStartTime
       long longLat = 0;
       auto lastCycle = mean::readTSC();
       while ((ops <= 0 || completed < ops) && keep_running) {
          // do {
+         const float rateNow = rate.load(std::memory_order_relaxed);
+         if (rateNow != scheduledRate) {
+            // new rate (--sweep): restart the schedule, the backlog of the old rate would be issued as a burst
+            scheduledRate = rateNow;
+            nextStartTime = mean::readTSC();
+            blockedAt = 0;
+         }
+         const int reserved = options.iodepth - depth.load(std::memory_order_relaxed); // requests not used at a lower depth
          if (options.breakEvery <= 0 || (time + 1) % (options.breakEvery + options.breakFor) < options.breakEvery) { // check if there is a break
-            while (availableReqStackCnt > 0 && ((ops <= 0 || completed < ops) && keep_running)) {
-               if (options.rateLimit > 0) { // when rate limiting is enabled only add more if needed
+            while (availableReqStackCnt > reserved && ((ops <= 0 || completed < ops) && keep_running)) {
+               u64 intended = 0;
+               if (rateNow > 0) { // when rate limiting is enabled only add more if needed
                   auto now = mean::readTSC();
                   if (now >= nextStartTime) {
-                     if (mean::tscDifferenceS(now, nextStartTime) > 5) {
+                     // open loop: the schedule is the backlog, arrivals that are due are issued as soon as a request is free
+                     if (!options.openLoop && mean::tscDifferenceS(now, nextStartTime) > 5) {
                         longLat++;
                         nextStartTime = now;
                         std::cout << "reset" << std::endl
                                   << std::flush;
                      }
-                     double d = 1 / options.rateLimit;
+                     double d = 1 / rateNow;
                      if (options.exponentialRate) {
-                        d = rateLimitExpDist(gen);
+                        d = rateLimitExpDist(gen) / rateNow;
+                     }
+                     if (options.openLoop) {
+                        intended = nextStartTime;
+                        if (intended <= blockedAt) {
+                           stats.missedSchedule++;
+                        }
                      }
                      nextStartTime += mean::nsToTSC(d * 1e9);
                   } else {
@@ -437,6 +456,7 @@ class RequestGenerator {
                IoBaseRequest reqCpy;
                availableReqStackCnt--;
                reqCpy.id = availableReqStack[availableReqStackCnt];
+               intendedTime[reqCpy.id] = intended;
                reqCpy.user = cb;
                prepareRequest(reqCpy);
                // if request addr is dividable by page size, the submit a trim command first
@@ -457,6 +477,12 @@ class RequestGenerator {
                ioChannel.push(reqCpy);
                submitted++;
             }
+            if (options.openLoop && rateNow > 0 && availableReqStackCnt <= reserved) {
+               auto now = mean::readTSC();
+               if (now >= nextStartTime) {
+                  blockedAt = now;
+               }
+            }
             ioChannel.submit();
          }
 
@@ -491,15 +517,15 @@ class RequestGenerator {
                auto clockTimeNow = getSeconds();
                auto timeDiff = clockTimeNow - lastPrintTimeClock;
                lastPrintTimeClock = clockTimeNow;
-               stats.printStats(statsStr, options, localTime, lastPrintTime, timeDiff, statsFileExists, genId, patternGen.options.patternString, patternGen.patternDetails());
-               statsFile << statsStr << std::endl;
-               statsStr.clear();
+               stats.takeSnapshot(statsRecord, localTime, lastPrintTime, timeDiff);
+               statsRecord.threadRate = rate.load(std::memory_order_relaxed);
+               statsRing.push(statsRecord);
                lastPrintTime = localTime;
             }
          }
 
          auto nowCycle = mean::readTSC();
-         stats.cycleHistEverySecond.increaseSlot(tscDifferenceUs(nowCycle, lastCycle));
+         stats.cycleHistEverySecond.increaseSlot(tscDifferenceNs(nowCycle, lastCycle));
          lastCycle = nowCycle;
       }
       stats.time = (getSeconds() - start);
@@ -509,6 +535,7 @@ class RequestGenerator {
          ioChannel.submit();
          polled += ioChannel.poll();
       }
+      stats.cpuTime = threadCpuSeconds() - cpuStart;
       std::stringstream ss;
       ioChannel.printCounters(ss);
       ss << endl;
@@ -521,14 +548,19 @@ class RequestGenerator {
    static constexpr int NEXT_SIZE = 1;
    int next_seq_ptr = NEXT_SIZE;
    std::array<uint64_t, NEXT_SIZE> next_seq;
-   uint64_t patternGenerator() {
+   std::array<uint8_t, NEXT_SIZE> next_handle;
+   // handle: placement handle of the access (--placement)
+   uint64_t patternGenerator(uint8_t* handle = nullptr) {
       uint64_t addr;
       if (next_seq_ptr == NEXT_SIZE) {
          for (int i = 0; i < NEXT_SIZE; i++) {
-            next_seq[i] = patternGen.accessPatternGenerator(gen);
+            next_seq[i] = patternGen.accessPatternGenerator(gen, next_handle[i]);
          }
          next_seq_ptr = 0;
       }
+      if (handle) {
+         *handle = next_handle[next_seq_ptr];
+      }
       int64_t block = next_seq[next_seq_ptr++];
       if (options.trackPatternAccess) {
          if (patternAccess.empty()) {
@@ -591,7 +623,9 @@ class RequestGenerator {
          volatile float randrw = rwDist(mersene);
          if (options.writePercent > 0 && randrw <= options.writePercent) {
             // write
-            req.addr = patternGenerator();
+            uint8_t handle;
+            req.addr = patternGenerator(&handle);
+            req.hint = patternGen.placementHandles > 0 ? handle : -1;
             // std::cout << req.addr << std::endl;
             // static int cnt = 0;
             // cnt++;
@@ -617,6 +651,7 @@ class RequestGenerator {
             assert(req.addr + req.len <= options.filesize);
             assert(req.addr % 512 == 0);
             req.type = IoRequestType::Read;
+            req.hint = -1;
             req.data = readData[req.id];
             preparedReads++;
          }
@@ -626,17 +661,9 @@ class RequestGenerator {
    uint64_t evaluateIocb(const IoBaseRequest& req) {
       uint64_t sum = 0;
       // ensure(req.device == genId);
-      if (options.enableIoTracing) {
-         IoTrace::IoStat& ios = ioTrace.ioTrace.at(ioTrace.evaluatedtIos);
-         ios.threadId = genId;
-         ios.reqId = req.id;
-         ios.begin = req.stats.push_time;
-         ios.submit = req.stats.submit_time;
-         ios.end = req.stats.completion_time;
-         ios.type = req.type;
-         ios.addr = req.addr;
-         ios.len = req.len;
-         ioTrace.evaluatedtIos++;
+      if (ioTrace) {
+         // stats.completion_time is only set after this callback
+         ioTrace->push({req.stats.push_time, readTSC(), req.addr, (u32)req.len, (u16)req.id, (u8)req.type});
       }
       if (!options.enableLatenyTracking) {
          if (req.type == IoRequestType::Read) {
@@ -649,7 +676,10 @@ class RequestGenerator {
             raise(SIGTRAP);
          }
       } else {
-         const auto thisTime = tscDifferenceUs(readTSC(), req.stats.push_time);
+         const auto now = readTSC();
+         const auto thisTime = tscDifferenceNs(now, req.stats.push_time);
+         const auto intended = intendedTime[req.id];
+         const auto responseTime = intended ? tscDifferenceNs(now, intended) : thisTime;
          if (req.type == IoRequestType::Fsync) {
             stats.fdatasyncTotalTime += thisTime;
             stats.fdatasyncHist.increaseSlot(thisTime);
@@ -667,11 +697,15 @@ class RequestGenerator {
             stats.reads++;
             //}
             stats.readHistEverySecond.increaseSlot(thisTime);
+            stats.readResponseHist.increaseSlot(responseTime);
+            stats.readResponseHistEverySecond.increaseSlot(responseTime);
             // assert(((char*)(*c).aio_buf)[0] == (char)(*c).aio_offset);
          } else {
             stats.writeTotalTime += thisTime;
             stats.writeHist.increaseSlot(thisTime);
             stats.writeHistEverySecond.increaseSlot(thisTime);
+            stats.writeResponseHist.increaseSlot(responseTime);
+            stats.writeResponseHistEverySecond.increaseSlot(responseTime);
             stats.writes++;
          }
       }
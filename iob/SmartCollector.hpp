@@ -0,0 +1,164 @@
+#pragma once
+
+#include "SeqLock.hpp"
+#include "ThreadBase.hpp"
+#include "Time.hpp"
+#include "io/impl/NvmeLog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace mean {
+
+// one sample of the smart (02h) and ocp (c0) logs
+struct SmartSample {
+   long time = 0;         // tick of the main loop, like time in iob-log
+   float exactTime = 0;   // s since the start of the main loop, like exacttime in iob-log
+   uint32_t fetchUs = 0;  // both log pages
+   bool ocp = false;
+   bool smart = false;
+   // ocp
+   uint64_t phyWrites = 0; // bytes
+   uint64_t phyReads = 0;
+   uint64_t softEcc = 0;
+   uint64_t unalignedIo = 0;
+   uint32_t maxEraseCount = 0;
+   uint32_t minEraseCount = 0;
+   uint8_t percentFreeBlocks = 0;
+   uint8_t throttling = 0;
+   // smart
+   uint8_t criticalWarning = 0;
+   uint8_t availableSpare = 0;
+   uint8_t percentageUsed = 0;
+   uint16_t temperature = 0; // K
+   uint64_t dataUnitsRead = 0;
+   uint64_t dataUnitsWritten = 0;
+   uint64_t hostReads = 0;
+   uint64_t hostWrites = 0;
+   uint64_t busyTime = 0;
+   uint64_t powerOnHours = 0;
+   uint64_t unsafeShutdowns = 0;
+   uint64_t mediaErrors = 0;
+   uint64_t errorLogEntries = 0;
+   uint32_t warningTempTime = 0;
+   uint32_t criticalTempTime = 0;
+};
+
+// Fetches the smart and ocp log pages every interval with admin commands on a controller fd that stays open
+// (no sudo nvme-cli processes), on its own thread so that neither the fetch nor the csv write delays the 1 Hz
+// stats loop. The stats loop reads the latest sample through a seqlock. Samples go to iob-smartlog-<prefix>.csv
+// (iob-smart-<prefix>.csv has the json lines of nvme-cli of older versions).
+class SmartCollector : public ThreadBase {
+   const std::string prefix;
+   const std::string hash;
+   const long intervalMs;
+   const std::atomic<long>& time;
+   const float startTime;
+   int fd = -1;
+   SeqLock<SmartSample> last;
+   std::ofstream csv;
+
+   SmartSample fetch() {
+      SmartSample s;
+      NvmeLog log;
+      auto begin = readTSC();
+      s.ocp = log.loadOCPSmartLog(fd);
+      s.smart = log.loadSmartLog(fd);
+      s.fetchUs = tscDifferenceUs(readTSC(), begin);
+      s.time = time;
+      s.exactTime = getSeconds() - startTime;
+      if (s.ocp) {
+         s.phyWrites = log.physicalMediaUnitsWrittenBytes();
+         s.phyReads = log.physicalMediaUnitsReadBytes();
+         s.softEcc = log.softECCError();
+         s.unalignedIo = log.unalignedIO();
+         s.maxEraseCount = log.maxUserDataEraseCount();
+         s.minEraseCount = log.minUserDataEraseCount();
+         s.percentFreeBlocks = log.percentFreeBlocks();
+         s.throttling = log.currentThrottlingStatus();
+      }
+      if (s.smart) {
+         s.criticalWarning = log.criticalWarning();
+         s.availableSpare = log.availableSpare();
+         s.percentageUsed = log.percentageUsed();
+         s.temperature = log.temperatureKelvin();
+         s.dataUnitsRead = log.smart64(SMART_DUR);
+         s.dataUnitsWritten = log.smart64(SMART_DUW);
+         s.hostReads = log.smart64(SMART_HRC);
+         s.hostWrites = log.smart64(SMART_HWC);
+         s.busyTime = log.smart64(SMART_CBT);
+         s.powerOnHours = log.smart64(SMART_POH);
+         s.unsafeShutdowns = log.smart64(SMART_US);
+         s.mediaErrors = log.smart64(SMART_MDIE);
+         s.errorLogEntries = log.smart64(SMART_NEL);
+         s.warningTempTime = log.smart32(SMART_WCTT);
+         s.criticalTempTime = log.smart32(SMART_CCTT);
+      }
+      return s;
+   }
+   void write(const SmartSample& s) {
+      csv << prefix << "," << hash << "," << s.time << "," << s.exactTime << "," << s.fetchUs << "," << s.ocp << "," << s.smart;
+      csv << "," << s.phyWrites << "," << s.phyReads << "," << s.softEcc << "," << s.unalignedIo << "," << s.maxEraseCount << "," << s.minEraseCount;
+      csv << "," << (int)s.percentFreeBlocks << "," << (int)s.throttling;
+      csv << "," << (int)s.criticalWarning << "," << (int)s.availableSpare << "," << (int)s.percentageUsed << "," << s.temperature;
+      csv << "," << s.dataUnitsRead << "," << s.dataUnitsWritten << "," << s.hostReads << "," << s.hostWrites << "," << s.busyTime;
+      csv << "," << s.powerOnHours << "," << s.unsafeShutdowns << "," << s.mediaErrors << "," << s.errorLogEntries;
+      csv << "," << s.warningTempTime << "," << s.criticalTempTime << "\n";
+   }
+
+ public:
+   // time, startTime: the tick and the start (getSeconds) of the main loop
+   SmartCollector(std::string prefix, std::string hash, long intervalMs, const std::atomic<long>& time, float startTime)
+       : ThreadBase("smart", 0), prefix(std::move(prefix)), hash(std::move(hash)), intervalMs(std::max(intervalMs, 10L)), time(time), startTime(startTime) {
+      fd = NvmeLog::openController();
+      std::string name = "iob-smartlog-" + this->prefix + ".csv";
+      bool exists = std::ifstream(name).good();
+      csv.open(name, std::ios_base::app);
+      if (!exists) {
+         csv << "prefix,hash,time,exacttime,fetchus,ocp,smart,phywrites,phyreads,softecc,unalignedio,maxerase,minerase,percentfreeblocks,throttling,";
+         csv << "criticalwarning,availablespare,percentageused,temperature,dataunitsread,dataunitswritten,hostreads,hostwrites,busytime,";
+         csv << "poweronhours,unsafeshutdowns,mediaerrors,errorlogentries,warningtemptime,criticaltemptime" << std::endl;
+      }
+      // the first sample before the stats loop starts
+      SmartSample s = fetch();
+      last.store(s);
+      write(s);
+   }
+   ~SmartCollector() override {
+      stop();
+      join();
+      csv.flush();
+      if (fd >= 0) {
+         close(fd);
+      }
+   }
+
+   int process() override {
+      long next = intervalMs;
+      while (keepRunning()) {
+         long now = (getSeconds() - startTime) * 1000;
+         if (now < next) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(next - now, 100L)));
+            continue;
+         }
+         next += intervalMs;
+         SmartSample s = fetch();
+         last.store(s);
+         write(s);
+      }
+      return 0;
+   }
+
+   // latest sample, lock-free
+   SmartSample latest() const {
+      return last.load();
+   }
+};
+
+} // namespace mean
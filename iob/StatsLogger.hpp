@@ -0,0 +1,86 @@
+#pragma once
+
+#include "RequestGenerator.hpp"
+#include "ThreadBase.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mean {
+
+// Writes the per-thread stats csv files (iob-stats-id<n>-<prefix>.csv). The generators only push a StatsRecord
+// into their ring every threadStatsInterval, this thread drains the rings, formats the lines and does the file
+// I/O, so neither the formatting nor a slow flush shows up in the submission loop.
+class StatsLogger : public ThreadBase {
+   struct Output {
+      RequestGenerator* gen;
+      std::ofstream file;
+      std::string patternDetails;
+   };
+   std::vector<std::unique_ptr<Output>> outputs;
+   std::string line;
+
+   bool drain() {
+      bool any = false;
+      StatsRecord rec;
+      for (auto& o: outputs) {
+         bool wrote = false;
+         while (o->gen->statsRing.pop(rec)) {
+            line.clear();
+            JobStats::printStats(line, rec, o->gen->options, o->gen->genId, o->gen->patternGen.options.patternString, o->patternDetails);
+            o->file << line << "\n";
+            wrote = true;
+         }
+         if (wrote) {
+            o->file.flush();
+            any = true;
+         }
+      }
+      return any;
+   }
+
+ public:
+   StatsLogger() : ThreadBase("statslog", 0) { line.reserve(8192); }
+   ~StatsLogger() override {
+      stop();
+      join();
+   }
+
+   // before start()
+   void add(RequestGenerator& gen) {
+      auto o = std::make_unique<Output>();
+      o->gen = &gen;
+      o->patternDetails = gen.patternGen.patternDetails();
+      std::string name = "iob-stats-id" + std::to_string(gen.genId) + "-" + gen.options.statsPrefix + ".csv";
+      bool exists = std::ifstream(name).good();
+      o->file.open(name, std::ios_base::app);
+      if (!exists) {
+         JobStats::printStatsHeader(line);
+         o->file << line << std::endl;
+      }
+      outputs.push_back(std::move(o));
+   }
+
+   int process() override {
+      while (keepRunning()) {
+         if (!drain()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+         }
+      }
+      // the last records, the generators are stopped
+      drain();
+      for (auto& o: outputs) {
+         if (o->gen->statsRing.overrunCount() > 0) {
+            std::cout << "stats: " << o->gen->name << " dropped " << o->gen->statsRing.overrunCount() << " lines" << std::endl;
+         }
+      }
+      return 0;
+   }
+};
+
+} // namespace mean
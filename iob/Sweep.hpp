@@ -0,0 +1,216 @@
+#pragma once
+
+#include "Exceptions.hpp"
+#include "LogHist.hpp"
+#include "RequestGenerator.hpp"
+
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace mean {
+
+// Latency vs. throughput curve in one run (--sweep): steps through the offered rate or the iodepth, waits for
+// steady state in every step (cv of the IOPS over the last window seconds), then measures for window seconds and
+// writes one line per step to iob-sweep-<prefix>.csv. Stops after the last step or once p99 crosses --sweepp99.
+//   rate:10k,20k,50k        rate:10k..400k+10k        iodepth:1..256*2
+struct SweepOptions {
+   std::string spec;
+   int window = 5;       // s
+   int maxWarmup = 60;   // s, measure anyway if it never gets steady
+   double cv = 0.05;     // stddev / mean of the IOPS over the window
+   double p99Limit = 0;  // us, 0: run all steps
+
+   bool rate = true;
+   std::vector<double> steps;
+
+   static double parseNumber(const std::string& str) {
+      size_t pos = 0;
+      double v = std::stod(str, &pos);
+      std::string suffix = str.substr(pos);
+      if (suffix == "k" || suffix == "K") {
+         v *= 1e3;
+      } else if (suffix == "m" || suffix == "M") {
+         v *= 1e6;
+      } else {
+         ensurem(suffix.empty(), "sweep: can't parse " + str);
+      }
+      return v;
+   }
+   void parse() {
+      auto colon = spec.find(':');
+      ensurem(colon != std::string::npos, "sweep: expected rate:<steps> or iodepth:<steps>, got " + spec);
+      std::string mode = spec.substr(0, colon);
+      ensurem(mode == "rate" || mode == "iodepth", "sweep: unknown mode " + mode + " (rate, iodepth)");
+      rate = mode == "rate";
+      std::string list = spec.substr(colon + 1);
+      auto range = list.find("..");
+      if (range != std::string::npos) {
+         auto op = list.find_first_of("+*", range);
+         ensurem(op != std::string::npos, "sweep: a range needs a step, from..to+step or from..to*factor");
+         double from = parseNumber(list.substr(0, range));
+         double to = parseNumber(list.substr(range + 2, op - range - 2));
+         double by = parseNumber(list.substr(op + 1));
+         ensurem(list[op] == '+' ? by > 0 : by > 1, "sweep: the range would not end");
+         for (double v = from; v <= to * (1 + 1e-9); v = list[op] == '+' ? v + by : v * by) {
+            steps.push_back(v);
+         }
+      } else {
+         size_t start = 0;
+         while (start <= list.size()) {
+            auto comma = list.find(',', start);
+            steps.push_back(parseNumber(list.substr(start, comma - start)));
+            if (comma == std::string::npos) {
+               break;
+            }
+            start = comma + 1;
+         }
+      }
+      ensurem(!steps.empty(), "sweep: no steps in " + spec);
+      for (double v: steps) {
+         ensurem(rate || (v >= 1 && v == std::floor(v)), "sweep: iodepth steps have to be whole numbers >= 1, got " + std::format("{}", v));
+      }
+   }
+};
+
+class Sweep {
+   const SweepOptions options;
+   const JobOptions& jobOptions;
+   std::vector<RequestGenerator*> gens;
+   std::ofstream csv;
+
+   size_t step = 0;
+   long stepStart = 0;
+   long measureStart = -1; // -1: warming up
+   bool steady = false;
+   std::vector<long> iops; // per second of the current step
+   long readsInWindow = 0;
+   // all threads at the start of the measurement
+   LogHist readBefore;
+   LogHist writeBefore;
+   u64 missedBefore = 0;
+   long phyWritesBefore = 0;
+   long hostWritesBefore = 0;
+
+   // response latency (equal to the service latency without --openloop)
+   void snapshot(LogHist& read, LogHist& write, u64& missed) {
+      read.resetData();
+      write.resetData();
+      missed = 0;
+      for (auto* g: gens) {
+         read += g->stats.readResponseHist;
+         write += g->stats.writeResponseHist;
+         missed += g->stats.missedSchedule;
+      }
+   }
+   void apply() {
+      const double target = options.steps[step];
+      for (auto* g: gens) {
+         if (options.rate) {
+            g->setRate(target / gens.size());
+         } else {
+            g->setDepth(target);
+         }
+      }
+      std::cout << "sweep: step " << step << " " << (options.rate ? "rate: " : "iodepth: ") << target << std::endl;
+   }
+   bool isSteady() const {
+      if (iops.size() < (size_t)options.window) {
+         return false;
+      }
+      auto first = iops.end() - options.window;
+      double mean = std::accumulate(first, iops.end(), 0.0) / options.window;
+      double sq = 0;
+      for (auto it = first; it != iops.end(); it++) {
+         sq += (*it - mean) * (*it - mean);
+      }
+      return mean > 0 && std::sqrt(sq / options.window) / mean < options.cv;
+   }
+
+ public:
+   Sweep(SweepOptions options, const JobOptions& jobOptions, std::vector<RequestGenerator*> gens) : options(std::move(options)), jobOptions(jobOptions), gens(std::move(gens)) {
+      std::string name = "iob-sweep-" + jobOptions.statsPrefix + ".csv";
+      bool exists = std::ifstream(name).good();
+      csv.open(name, std::ios_base::app);
+      if (!exists) {
+         csv << "hash,prefix,step,mode,target,warmup,steady,seconds,iops,readiops,writeiops,mibs,p50,p99,p99p9,r50,r99,r99p9,w50,w99,w99p9,missed,wa" << std::endl;
+      }
+      // the csv reports the target, a step the generators can't reach must not run
+      for (double v: this->options.steps) {
+         ensurem(this->options.rate || v <= jobOptions.iodepth, "sweep: iodepth step " + std::to_string((int)v) + " exceeds the iodepth " + std::to_string(jobOptions.iodepth) + " of the run");
+      }
+      apply();
+   }
+
+   // once per second from the main loop, false: sweep done
+   bool tick(long time, long readsPS, long writesPS, long phyWrites, long hostWrites) {
+      iops.push_back(readsPS + writesPS);
+      readsInWindow += readsPS;
+      if (measureStart < 0) {
+         steady = isSteady();
+         if (!steady && time - stepStart < options.maxWarmup) {
+            return true;
+         }
+         measureStart = time;
+         iops.clear();
+         readsInWindow = 0;
+         snapshot(readBefore, writeBefore, missedBefore);
+         phyWritesBefore = phyWrites;
+         hostWritesBefore = hostWrites;
+         return true;
+      }
+      if (time - measureStart < options.window) {
+         return true;
+      }
+      // step done: the difference to the snapshot is the measurement window
+      LogHist read;
+      LogHist write;
+      u64 missed;
+      snapshot(read, write, missed);
+      read -= readBefore;
+      write -= writeBefore;
+      LogHist all;
+      all += read;
+      all += write;
+      const double percentiles[] = {50, 99, 99.9};
+      u64 p[3];
+      u64 r[3];
+      u64 w[3];
+      all.getPercentiles(percentiles, p, 3);
+      read.getPercentiles(percentiles, r, 3);
+      write.getPercentiles(percentiles, w, 3);
+      const double seconds = iops.size();
+      const double total = std::accumulate(iops.begin(), iops.end(), 0.0) / seconds;
+      const long hostBytes = (hostWrites - hostWritesBefore) * jobOptions.bs;
+      const double wa = hostBytes > 0 ? (phyWrites - phyWritesBefore) * 1.0 / hostBytes : 0;
+
+      csv << jobOptions.logHash << "," << jobOptions.statsPrefix << "," << step << "," << (options.rate ? "rate" : "iodepth") << "," << options.steps[step];
+      csv << "," << measureStart - stepStart << "," << steady << "," << seconds;
+      csv << "," << total << "," << readsInWindow / seconds << "," << total - readsInWindow / seconds << "," << total * jobOptions.bs / MEBI;
+      csv << "," << p[0] / 1e3 << "," << p[1] / 1e3 << "," << p[2] / 1e3;
+      csv << "," << r[0] / 1e3 << "," << r[1] / 1e3 << "," << r[2] / 1e3;
+      csv << "," << w[0] / 1e3 << "," << w[1] / 1e3 << "," << w[2] / 1e3;
+      csv << "," << missed - missedBefore << "," << wa << std::endl;
+      std::cout << "sweep: step " << step << " " << options.steps[step] << " -> " << total << " IOPS p50: " << p[0] / 1e3 << " p99: " << p[1] / 1e3 << " p99.9: " << p[2] / 1e3 << " us" << (steady ? "" : " (not steady)") << std::endl;
+
+      if (options.p99Limit > 0 && p[1] / 1e3 > options.p99Limit) {
+         std::cout << "sweep: p99 over " << options.p99Limit << " us, done" << std::endl;
+         return false;
+      }
+      if (++step == options.steps.size()) {
+         return false;
+      }
+      stepStart = time;
+      measureStart = -1;
+      iops.clear();
+      readsInWindow = 0;
+      apply();
+      return true;
+   }
+};
+
+} // namespace mean
@@ -1,7 +1,7 @@
 #pragma once
 // -------------------------------------------------------------------------------------
-#include "Hist.hpp"
 #include "IoRequest.hpp"
+#include "LogHist.hpp"
 #include "Time.hpp"
 #include "Units.hpp"
 // -------------------------------------------------------------------------------------
@@ -21,21 +21,21 @@ struct IoChannelCounters {
    std::atomic<s64> outstandingWrite = 0;
    std::atomic<u64> completed = 0;
    // -------------------------------------------------------------------------------------
-   Hist<int, u64> readHist{1000, 0, 10000};
-   Hist<int, u64> writeHist{1000, 0, 10000};
+   LogHist readHist; // ns
+   LogHist writeHist; // ns
    // -------------------------------------------------------------------------------------
-   Hist<int, u64> pollHist{1000, 0, 500};
-   Hist<int, u64> outstandingHist{1000, 0, 2000};
-   Hist<int, u64> outstandingHistRead{1000, 0, 2000};
-   Hist<int, u64> outstandingHistWrite{1000, 0, 2000};
+   LogHist pollHist;
+   LogHist outstandingHist;
+   LogHist outstandingHistRead;
+   LogHist outstandingHistWrite;
    // -------------------------------------------------------------------------------------
 // #define IO_PER_SSD_LATENCY_COUNTERS
 #ifdef IO_PER_SSD_LATENCY_COUNTERS
    struct DeviceCounters {
       int outstanding = 0;
-      Hist<int, u64> readHist{2000, 0, 100000};
-      Hist<int, u64> writeHist{2000, 0, 10000};
-      u64 maxReadLat = 0;
+      LogHist readHist; // ns
+      LogHist writeHist; // ns
+      u64 maxReadLat = 0; // ns
    };
    std::vector<DeviceCounters> device_counters;
    // -------------------------------------------------------------------------------------
@@ -66,7 +66,7 @@ struct IoChannelCounters {
    void handleSubmit(int submitted) {
       pushed.fetch_add(-submitted);
       outstanding.fetch_add(submitted);
-      outstandingHist.increaseSlot(outstanding);
+      outstandingHist.increaseSlot(std::max<s64>(outstanding, 0));
    }
    void handlePoll(int polled) {
       outstanding.fetch_add(-polled);
@@ -80,7 +80,7 @@ struct IoChannelCounters {
    }
    void handleCompletedReq(IoBaseRequest& req) {
       req.stats.completion_time = readTSC();
-      const auto diff = tscDifferenceUs(req.stats.completion_time, req.stats.push_time);
+      const auto diff = tscDifferenceNs(req.stats.completion_time, req.stats.push_time);
 #ifdef IO_PER_SSD_LATENCY_COUNTERS
       device_counters[req.device].outstanding--;
 #endif
@@ -92,7 +92,7 @@ struct IoChannelCounters {
          device_counters[req.device].maxReadLat = std::max(device_counters[req.device].maxReadLat, diff);
 #endif
          // leanstore::SSDCounters::myCounters().reads[req.device]++;
-         outstandingHistRead.increaseSlot(outstandingRead);
+         outstandingHistRead.increaseSlot(std::max<s64>(outstandingRead, 0));
          outstandingRead--;
       } else if (req.type == IoRequestType::Write) {
          writeHist.increaseSlot(diff);
@@ -101,7 +101,7 @@ struct IoChannelCounters {
 #endif
          // leanstore::WorkerCounters::myCounters().ssd_write_latency.increaseSlot(diff);
          // leanstore::SSDCounters::myCounters().writes[req.device]++;
-         outstandingHistWrite.increaseSlot(outstandingWrite);
+         outstandingHistWrite.increaseSlot(std::max<s64>(outstandingWrite, 0));
          outstandingWrite--;
       }
    }
@@ -111,8 +111,8 @@ struct IoChannelCounters {
    void printCounters(std::ostream& ss) {
       ss << std::setprecision(3);
       ss << pushed << "," << outstanding << "," << completed / KILO << ",";
-      ss << readHist.getPercentile(50) << "," << readHist.getPercentile(99.9) << ",";
-      ss << writeHist.getPercentile(50) << "," << writeHist.getPercentile(99.9) << ",";
+      ss << readHist.getPercentile(50) / 1e3 << "," << readHist.getPercentile(99.9) / 1e3 << ",";
+      ss << writeHist.getPercentile(50) / 1e3 << "," << writeHist.getPercentile(99.9) / 1e3 << ",";
       ss << pollHist.getPercentile(10) << "," << pollHist.getPercentile(50) << "," << pollHist.getPercentile(90) << ",";
       ss << outstandingHist.getPercentile(10) << "," << outstandingHist.getPercentile(50) << "," << outstandingHist.getPercentile(90);
    }
@@ -120,13 +120,13 @@ struct IoChannelCounters {
 #ifdef IO_PER_SSD_LATENCY_COUNTERS
       auto& c = leanstore::SSDCounters::myCounters();
       for (unsigned i = 0; i < device_counters.size(); i++) {
-         c.read_latncy50p[i] = device_counters[i].readHist.getPercentile(50);
-         c.read_latncy99p[i] = device_counters[i].readHist.getPercentile(99);
-         c.read_latncy99p9[i] = device_counters[i].readHist.getPercentile(99.9);
-         c.read_latncy_max[i] = device_counters[i].maxReadLat;
-         c.write_latncy50p[i] = device_counters[i].writeHist.getPercentile(50);
-         c.write_latncy99p[i] = device_counters[i].writeHist.getPercentile(99);
-         c.write_latncy99p9[i] = device_counters[i].writeHist.getPercentile(99.9);
+         c.read_latncy50p[i] = device_counters[i].readHist.getPercentile(50) / KILO;
+         c.read_latncy99p[i] = device_counters[i].readHist.getPercentile(99) / KILO;
+         c.read_latncy99p9[i] = device_counters[i].readHist.getPercentile(99.9) / KILO;
+         c.read_latncy_max[i] = device_counters[i].maxReadLat / KILO;
+         c.write_latncy50p[i] = device_counters[i].writeHist.getPercentile(50) / KILO;
+         c.write_latncy99p[i] = device_counters[i].writeHist.getPercentile(99) / KILO;
+         c.write_latncy99p9[i] = device_counters[i].writeHist.getPercentile(99.9) / KILO;
          // c.outstandingx_max[i] = std::max(device_counters[i].outstanding, (int)c.outstandingx_max[i].load());
          // c.outstandingx_min[i] = std::min(device_counters[i].outstanding, (int)c.outstandingx_min[i].load());
       }
@@ -151,8 +151,8 @@ struct IoChannelCounterAggregator {
       totalPushed += counters.pushed;
       totalOutstanding += counters.outstanding;
       totalCompleted += counters.completed;
-      maxRead99p9 = std::max(maxRead99p9, (int)counters.readHist.getPercentile(99.9));
-      maxWrite99p9 = std::max(maxWrite99p9, (int)counters.writeHist.getPercentile(99.9));
+      maxRead99p9 = std::max(maxRead99p9, (int)(counters.readHist.getPercentile(99.9) / KILO));
+      maxWrite99p9 = std::max(maxWrite99p9, (int)(counters.writeHist.getPercentile(99.9) / KILO));
    }
    void print(std::ostream& ss) const {
       ss << "ioaggr:(" << count << ")[p: " << totalPushed << " o: " << totalOutstanding << " c: " << totalCompleted / KILO << "k] ";
@@ -12,6 +12,10 @@ class IoEnvironment {
    // Device
    virtual u64 storageSize() = 0;
    virtual DeviceInformation getDeviceInfo() = 0;
+   // ocp smart log of emulated drives, false: read it from the device
+   virtual bool ocpSmartLog(uint8_t* log, size_t len) { return false; }
+   // emulated drive that already holds a written state (restored ssdsim state), init=auto leaves it as it is
+   virtual bool initialized() { return false; }
 
  protected:
    virtual void* allocIoMemory(size_t size, size_t align) = 0;
@@ -38,6 +38,18 @@ class IoEnvironmentImpl : public IoEnvironment {
    DeviceInformation getDeviceInfo() override {
       return io_env->getDeviceInfo();
    };
+   bool ocpSmartLog(uint8_t* log, size_t len) override {
+      if constexpr (requires { io_env->ocpSmartLog(log, len); }) {
+         return io_env->ocpSmartLog(log, len);
+      }
+      return false;
+   };
+   bool initialized() override {
+      if constexpr (requires { io_env->initialized(); }) {
+         return io_env->initialized();
+      }
+      return false;
+   };
 
  protected:
    void* allocIoMemory(size_t size, size_t align) override {
@@ -5,6 +5,8 @@
 // -------------------------------------------------------------------------------------
 #include "impl/LibaioImpl.hpp"
 #include "impl/LiburingImpl.hpp"
+#include "impl/MemImpl.hpp"
+#include "impl/SsdSimImpl.hpp"
 // -------------------------------------------------------------------------------------
 namespace mean {
 std::unique_ptr<IoEnvironment> IoInterface::_instance = nullptr;
@@ -18,6 +20,10 @@ IoEnvironment& IoInterface::initInstance(const IoOptions& ioOptions) {
 #endif
    } else if (ioOptions.engine == "io_uring") {
       _instance = std::unique_ptr<IoEnvironment>(new IoEnvironmentImpl<LiburingEnv, LiburingChannel, LiburingIoRequest>(ioOptions));
+   } else if (ioOptions.engine == "null" || ioOptions.engine == "ramdisk") {
+      _instance = std::unique_ptr<IoEnvironment>(new IoEnvironmentImpl<MemEnv, MemChannel, MemIoRequest>(ioOptions));
+   } else if (ioOptions.engine == "ssdsim") {
+      _instance = std::unique_ptr<IoEnvironment>(new IoEnvironmentImpl<SsdSimEnv, SsdSimChannel, SsdSimIoRequest>(ioOptions));
 #ifdef LEANSTORE_INCLUDE_XNVME
    } else if (ioOptions.engine.find("xnvme") != string::npos) {
       _instance = std::unique_ptr<RaidEnvironment>(new RaidEnv<XnvmeEnv, XnvmeChannel, XnvmeRequest>(ioOptions));
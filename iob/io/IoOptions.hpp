@@ -20,10 +20,32 @@ struct IoOptions {
    bool ioUringFixedBuffers = false;
    int ioUringShareWq = 0;
    bool ioUringNVMePassthrough = false;
+   bool ioUringSingleIssuer = false;  // only the generator thread submits, the ring is enabled on its first submit
+   bool ioUringDeferTaskrun = false;  // completions run when the issuer reaps (implies single issuer)
+   bool ioUringCoopTaskrun = false;   // no interrupts of the issuer for completion task work
+   bool ioUringRegisterRingFd = false; // io_uring_enter with a registered ring fd, no fd lookup per syscall
+   int ioUringWaitAfter = 0;          // empty polls before blocking in submit_and_wait, 0: never block
+   // -------------------------------------------------------------------------------------
+   u64 memorySize = 0;      // null/ramdisk/ssdsim: size of the emulated device
+   u64 memoryLatencyNs = 0; // null/ramdisk: latency per request
+   // ssdsim: geometry, gc and timing of the simulated drive
+   u64 simPageSize = 4 * KIBI;
+   u64 simEraseSize = 8 * MEBI;
+   double simFill = 0.9; // logical / physical capacity
+   std::string simGC = "greedy";
+   int simDies = 64;
+   u64 simReadNs = 60 * KILO;
+   u64 simProgramNs = 200 * KILO; // per page
+   u64 simEraseNs = 3 * MEGA;
+   std::string simState; // file that keeps the drive between runs, empty: new drive every run
    // -------------------------------------------------------------------------------------
    int channelCount = 0;
    // -------------------------------------------------------------------------------------
    IoOptions() = default;
+   // no device behind the engine, e.g. no nvme smart logs
+   bool emulated() const { return engine == "null" || engine == "ramdisk" || engine == "ssdsim"; }
+   // reads return the written data, the data can be checked
+   bool storesData() const { return engine != "null" && engine != "ssdsim"; }
    void check() const {
       if (async_batch_submit > iodepth) {
          throw std::logic_error("iodepth must be higher than async_batch_submit");
@@ -23,6 +23,7 @@ void IoBaseRequest::copyFields(const IoBaseRequest& usr) {
    len = usr.len;
    user = usr.user;
    write_back = usr.write_back;
+   hint = usr.hint;
 }
 // -------------------------------------------------------------------------------------
 void IoBaseRequest::print(std::ostream& ss) const {
@@ -62,6 +62,10 @@ class RaidController {
    DeviceType deviceTypeOrFd(int d) {
       return fds.at(d);
    }
+   // index of a device returned by calc, e.g. the registered file index with io_uring fixed files
+   int deviceIndex(const DeviceType* d) const {
+      return d - fds.data();
+   }
    void forEach(std::function<void(std::string& dev, DeviceType& fd)> fun) {
       const int size = devices.size();
       for (int i = 0; i < size; i++) {
@@ -98,6 +98,18 @@ LiburingChannel::LiburingChannel(RaidController<int>& raidCtl, const IoOptions&
    iouParameters.flags |= ioOptions.ioUringPollMode ? IORING_SETUP_IOPOLL : 0;
    // iouParameters.flags |= IORING_FEAT_NATIVE_WORKERS;
    iouParameters.flags |= ioOptions.ioUringShareWq > 0 ? IORING_SETUP_SQPOLL : 0;
+   ensurem(!ioOptions.ioUringDeferTaskrun || ioOptions.ioUringShareWq == 0, "io_uring defer taskrun does not work with sqpoll");
+   if (ioOptions.ioUringSingleIssuer || ioOptions.ioUringDeferTaskrun) {
+      // the ring is created (and buffers registered) by the main thread, the issuer is the thread that enables it
+      iouParameters.flags |= IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_R_DISABLED;
+      disabledRing = true;
+      enabled = false;
+   }
+   if (ioOptions.ioUringRegisterRingFd) {
+      enabled = false; // registered ring fds are per thread, the channel is created by the main thread
+   }
+   iouParameters.flags |= ioOptions.ioUringDeferTaskrun ? IORING_SETUP_DEFER_TASKRUN : 0;
+   iouParameters.flags |= ioOptions.ioUringCoopTaskrun ? IORING_SETUP_COOP_TASKRUN : 0;
    if (ioOptions.ioUringShareWq > 0 && env.channels.size() >= (unsigned)ioOptions.ioUringShareWq) {
       iouParameters.flags |= IORING_SETUP_ATTACH_WQ;
       // round robin the wq's
@@ -115,19 +127,43 @@ LiburingChannel::LiburingChannel(RaidController<int>& raidCtl, const IoOptions&
    // iovec iov;
    // iov.iov_base =
 
-   // int reg = io_uring_register_ring_fd(&ring);
-   // assert(reg == 1);
    std::vector<int> files(raidCtl.deviceCount());
    for (size_t i = 0; i < files.size(); i++) {
       files[i] = raidCtl.deviceTypeOrFd(i);
    }
-   // int reg = io_uring_register_files(&ring, &files[0], files.size());
-   // assert(reg == 0);
+   if (ioOptions.ioUringFixedBuffers) {
+      // sqes address the raid members by their index, saves the fd lookup and refcounting per io
+      int reg = io_uring_register_files(&ring, files.data(), files.size());
+      posix_check(reg == 0, "io_uring_register_files failed: ret: " + to_string(reg));
+      fixedFiles = true;
+   }
 
    // -------------------------------------------------------------------------------------
    request_stack.reserve(ioOptions.iodepth);
+   cqes.resize(ioOptions.iodepth);
+}
+// registered ring fds are per thread, so they are registered by the issuer as well
+void LiburingChannel::enable() {
+   if (disabledRing) {
+      int ret = io_uring_enable_rings(&ring);
+      posix_check(ret == 0, "io_uring_enable_rings failed: ret: " + to_string(ret));
+   }
+   if (ioOptions.ioUringRegisterRingFd) {
+      int reg = io_uring_register_ring_fd(&ring);
+      posix_check(reg == 1, "io_uring_register_ring_fd failed: ret: " + to_string(reg));
+   }
+   enabled = true;
 }
+// replaces the buffers registered before (e.g. by the init generator on the same channel)
 int LiburingChannel::registerBuffers(std::vector<std::pair<void*, uint64_t>>& iovec_pairs) {
+   if (!ioOptions.ioUringFixedBuffers) {
+      return 0;
+   }
+   if (!fixedBuffers.empty()) {
+      int ret = io_uring_unregister_buffers(&ring);
+      posix_check(ret == 0, "io_uring_unregister_buffers failed: ret: " + to_string(ret));
+      fixedBuffers.clear();
+   }
    std::vector<iovec> iovecs;
    iovecs.reserve(iovec_pairs.size());
    for (auto iovp: iovec_pairs) {
@@ -138,8 +174,20 @@ int LiburingChannel::registerBuffers(std::vector<std::pair<void*, uint64_t>>& io
    }
    int ret = io_uring_register_buffers(&ring, iovecs.data(), iovecs.size());
    posix_check(ret == 0, "io_uring_register_buffers failed: ret: " + to_string(ret) + " <= if it is twentytwo it could be because too many buffers were added (limit right tow is 16k)");
+   fixedBuffers = std::move(iovecs);
    return 0;
 }
+// registered buffer that holds [data, data + len), -1: not registered (e.g. write back buffers)
+int LiburingChannel::fixedBufferIndex(const void* data, u64 len) const {
+   const char* d = static_cast<const char*>(data);
+   for (size_t i = 0; i < fixedBuffers.size(); i++) {
+      const char* base = static_cast<const char*>(fixedBuffers[i].iov_base);
+      if (d >= base && d + len <= base + fixedBuffers[i].iov_len) {
+         return i;
+      }
+   }
+   return -1;
+}
 // -------------------------------------------------------------------------------------
 LiburingChannel::~LiburingChannel() {
    io_uring_queue_exit(&ring);
@@ -171,7 +219,8 @@ static void print_sqe(struct io_uring_sqe* sqe) {
           cmd->opcode, cmd->flags, cmd->rsvd1, cmd->nsid, cmd->cdw2, cmd->cdw3, cmd->metadata, cmd->addr, cmd->metadata_len, cmd->data_len, cmd->cdw10, cmd->cdw11, cmd->cdw12, cmd->cdw13, cmd->cdw14, cmd->cdw15, cmd->timeout_ms, cmd->rsvd2);
 }
 // -------------------------------------------------------------------------------------
-void prep_uring_cmd(uint8_t opcode, struct io_uring_sqe* sqe, int fd, struct iovec* iov, uint64_t slba, uint64_t nlb) {
+// hint: fdp placement handle of a write, -1: no directive
+void prep_uring_cmd(uint8_t opcode, struct io_uring_sqe* sqe, int fd, struct iovec* iov, uint64_t slba, uint64_t nlb, uint8_t hint = -1) {
    sqe->opcode = IORING_OP_URING_CMD;
    sqe->fd = fd;
    sqe->flags = 0;
@@ -188,12 +237,29 @@ void prep_uring_cmd(uint8_t opcode, struct io_uring_sqe* sqe, int fd, struct iov
    cmd->nsid = 1; // TODO
    cmd->opcode = opcode;
    cmd->cdw13 = 1 << 6; // DSM Sequential Request
+   if (hint != (uint8_t)-1) {
+      cmd->cdw12 |= 2 << 20;            // DTYPE: data placement directive
+      cmd->cdw13 |= (uint32_t)hint << 16; // DSPEC: placement handle
+   }
+}
+// passthrough with a registered buffer: the driver maps the buffer from the registered table
+static void prep_uring_cmd_fixed(struct io_uring_sqe* sqe, int bufIdx) {
+   if (bufIdx < 0) {
+      return;
+   }
+#ifdef IORING_URING_CMD_FIXED
+   sqe->uring_cmd_flags |= IORING_URING_CMD_FIXED;
+   sqe->buf_index = bufIdx;
+#endif
 }
 // NOLINTEND(modernize-use-auto)
 // -------------------------------------------------------------------------------------
 int LiburingChannel::_submit() {
    int submitted = 0;
    int reads = 0;
+   if (!enabled) {
+      enable();
+   }
    for (auto* req: request_stack) {
       // std::cout << "submit: " << i << " bf?: " << (void*)request_stack->submit_stack.get()[i]->base.user_data << std::endl << std::flush;
       struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
@@ -214,10 +280,16 @@ int LiburingChannel::_submit() {
          assert((uintptr_t)req->base.data % 512 == 0);
          // io_uring_prep_write(sqe, fd, dataBuf, req->base.len, req->base.addr);
          // std::cout << "write: buf: " << sqe->addr << " len: " << sqe->len << " addr: " << sqe->off << std::endl;
+         int file = fixedFiles ? raidCtl.deviceIndex(fd) : *fd;
+         int bufIdx = fixedBufferIndex(req->impl.iov.iov_base, req->impl.iov.iov_len);
+         fixedBufferIos += bufIdx >= 0;
          if (ioOptions.ioUringNVMePassthrough) {
-            prep_uring_cmd(nvme_cmd_write, sqe, *fd, &req->impl.iov, raidedOffset / lba_sz, req->impl.iov.iov_len / lba_sz);
+            prep_uring_cmd(nvme_cmd_write, sqe, file, &req->impl.iov, raidedOffset / lba_sz, req->impl.iov.iov_len / lba_sz, req->base.hint);
+            prep_uring_cmd_fixed(sqe, bufIdx);
+         } else if (bufIdx >= 0) {
+            io_uring_prep_write_fixed(sqe, file, req->impl.iov.iov_base, req->impl.iov.iov_len, raidedOffset, bufIdx);
          } else {
-            io_uring_prep_writev(sqe, *fd, &req->impl.iov, 1, raidedOffset);
+            io_uring_prep_writev(sqe, file, &req->impl.iov, 1, raidedOffset);
          }
          // std::cout << "write: " << req->iov.iov_base << " len: " << req->iov.iov_len << " addr: " << req->base.addr << std::endl;
          break;
@@ -229,10 +301,16 @@ int LiburingChannel::_submit() {
          assert((uintptr_t)req->base.data % 512 == 0);
          // io_uring_prep_read(sqe, fd, req->base.data, req->base.len, req->base.addr);
          // std::cout << "read buf: " << sqe->addr << " len: " << sqe->len << " off: " << sqe->off << std::endl;
+         int file = fixedFiles ? raidCtl.deviceIndex(fd) : *fd;
+         int bufIdx = fixedBufferIndex(req->impl.iov.iov_base, req->impl.iov.iov_len);
+         fixedBufferIos += bufIdx >= 0;
          if (ioOptions.ioUringNVMePassthrough) {
-            prep_uring_cmd(nvme_cmd_read, sqe, *fd, &req->impl.iov, raidedOffset / lba_sz, req->impl.iov.iov_len / lba_sz);
+            prep_uring_cmd(nvme_cmd_read, sqe, file, &req->impl.iov, raidedOffset / lba_sz, req->impl.iov.iov_len / lba_sz);
+            prep_uring_cmd_fixed(sqe, bufIdx);
+         } else if (bufIdx >= 0) {
+            io_uring_prep_read_fixed(sqe, file, req->impl.iov.iov_base, req->impl.iov.iov_len, raidedOffset, bufIdx);
          } else {
-            io_uring_prep_readv(sqe, *fd, &req->impl.iov, 1, raidedOffset);
+            io_uring_prep_readv(sqe, file, &req->impl.iov, 1, raidedOffset);
          }
          reads++;
          // std::cout << "read: " << req->iov.iov_base << " len: " << req->iov.iov_len << " addr: " << req->base.addr << std::endl;
@@ -255,6 +333,9 @@ int LiburingChannel::_submit() {
       default:
          throw std::logic_error("IoRequestType not supported");
       }
+      if (fixedFiles) {
+         sqe->flags |= IOSQE_FIXED_FILE;
+      }
       io_uring_sqe_set_data(sqe, req);
    }
    // LEANSTORE_BLOCK( PPCounters::myCounters().io_submits++; )
@@ -268,50 +349,63 @@ int LiburingChannel::_submit() {
    // request_stack->outstanding()	<< std::endl << std::flush;
    // ensure(request_stack.size() == submitted);
    request_stack.clear();
+   outstanding += submitted;
    return submitted;
 }
 // -------------------------------------------------------------------------------------
 int LiburingChannel::_poll(int min) {
    int done = 0;
-   if (ioOptions.ioUringPollMode) { // prohibits never entering the kernel when nothing is submitted.
-      // int submitted = io_uring_submit(&ring);
+   if (!enabled) {
+      enable();
    }
-   struct io_uring_cqe* cqe = nullptr;
    while (true) {
-      // int ok = io_uring_peek_cqe(&ring, &cqe);
-      unsigned int avail = 0;
-      // lib-internal call, doesn't actually poll/enter the kernel, only peaks cq.
-      int ok = __io_uring_peek_cqe(&ring, &cqe, &avail);
-      posix_check(ok == 0 || ok == -EAGAIN);
-      if (!cqe || ok == -EAGAIN) {
-         // prohibit starving from not actually polling io
-         [[maybe_unused]] int submitted = io_uring_submit(&ring); // enter kernel for polling
-         // assert(submitted==0);
-         int ok = __io_uring_peek_cqe(&ring, &cqe, &avail);
-         posix_check(ok == 0 || ok == -EAGAIN);
-         if (!cqe || ok == -EAGAIN) {
+      // only peeks the cq ring, doesn't enter the kernel
+      unsigned int count = io_uring_peek_batch_cqe(&ring, cqes.data(), cqes.size());
+      if (count == 0) {
+         if (done > 0) {
+            break; // something was reaped, enter the kernel on the next poll
+         }
+         if (ioOptions.ioUringWaitAfter > 0 && ++emptyPolls >= ioOptions.ioUringWaitAfter && outstanding > 0) {
+            // hybrid: spin for a couple of empty polls, then block for one completion
+            int ret = io_uring_submit_and_wait(&ring, 1);
+            posix_check(ret >= 0, "io_uring_submit_and_wait failed ret:" + std::to_string(ret));
+            waits++;
+         } else {
+            // prohibit starving from not actually polling io, also runs deferred completion task work
+            int ret = io_uring_submit_and_get_events(&ring);
+            posix_check(ret >= 0, "io_uring_submit_and_get_events failed ret:" + std::to_string(ret));
+         }
+         count = io_uring_peek_batch_cqe(&ring, cqes.data(), cqes.size());
+         if (count == 0) {
             break;
          }
       }
-      auto* req = reinterpret_cast<RaidRequest<LiburingIoRequest>*>(io_uring_cqe_get_data(cqe));
-      if ((ioOptions.ioUringNVMePassthrough && cqe->res != 0) || (!ioOptions.ioUringNVMePassthrough && cqe->res != (s32)req->base.len)) {
-         [[maybe_unused]] auto r = cqe->res;
-         [[maybe_unused]] auto* d = reinterpret_cast<LiburingIoRequest*>(io_uring_cqe_get_data(cqe));
-         req->base.print(std::cout);
-         throw std::logic_error("liburing io failed cqe->res != len. res: " + std::to_string((long)cqe->res) +
-                                " len: " + std::to_string(req->base.len));
+      emptyPolls = 0;
+      reapBatches++;
+      for (unsigned int i = 0; i < count; i++) {
+         struct io_uring_cqe* cqe = cqes[i];
+         auto* req = reinterpret_cast<RaidRequest<LiburingIoRequest>*>(io_uring_cqe_get_data(cqe));
+         if ((ioOptions.ioUringNVMePassthrough && cqe->res != 0) || (!ioOptions.ioUringNVMePassthrough && cqe->res != (s32)req->base.len)) {
+            req->base.print(std::cout);
+            throw std::logic_error("liburing io failed cqe->res != len. res: " + std::to_string((long)cqe->res) +
+                                   " len: " + std::to_string(req->base.len));
+         }
+         req->base.innerCallback.callback(&req->base);
       }
-      // std::cout << "res: " << cqe->res << std::endl;
-      done++;
-      // std::cout << "read ok: " << req->base.data << " len: " << req->base.len << " off: " << req->base.addr << std::endl;
-      io_uring_cqe_seen(&ring, cqe);
-      req->base.innerCallback.callback(&req->base);
+      // the callbacks only recycle requests, the cqes are released after the whole batch
+      io_uring_cq_advance(&ring, count);
+      done += count;
    }
+   outstanding -= done;
    return done;
 }
 // -------------------------------------------------------------------------------------
 void LiburingChannel::_printSpecializedCounters(std::ostream& ss) {
    ss << "uring: ";
+   if (ioOptions.ioUringFixedBuffers) {
+      ss << "fixed buffer ios: " << fixedBufferIos << " ";
+   }
+   ss << "reap batches: " << reapBatches << " waits: " << waits << " ";
 }
 // -------------------------------------------------------------------------------------
 } // namespace mean
@@ -28,6 +28,17 @@ class LiburingChannel : public LinuxBaseChannel {
    int outstanding = 0;
    int nothingPolledStarving = 0;
    int lba_sz = -1;
+   bool fixedFiles = false;
+   std::vector<iovec> fixedBuffers; // registered buffers (--ioufixed)
+   long fixedBufferIos = 0;
+   bool enabled = true; // false: enabled (R_DISABLED) and/or its fd registered by the first submitting thread
+   bool disabledRing = false; // created with IORING_SETUP_R_DISABLED
+   std::vector<struct io_uring_cqe*> cqes;
+   int emptyPolls = 0;
+   long reapBatches = 0;
+   long waits = 0;
+   // -------------------------------------------------------------------------------------
+   void enable();
 
  public:
    LiburingChannel(RaidController<int>& raidCtl, const IoOptions& ioOptions, LiburingEnv& env);
@@ -38,6 +49,7 @@ class LiburingChannel : public LinuxBaseChannel {
    int _poll(int min = 0);
    void _printSpecializedCounters(std::ostream& ss);
    int registerBuffers(std::vector<std::pair<void*, uint64_t>>& iovec_pairs);
+   int fixedBufferIndex(const void* data, u64 len) const;
 };
 // -------------------------------------------------------------------------------------
 } // namespace mean
@@ -0,0 +1,118 @@
+#include "MemImpl.hpp"
+// -------------------------------------------------------------------------------------
+#include "Exceptions.hpp"
+#include "Time.hpp"
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+#include <cstring>
+#include <string>
+#include <sys/mman.h>
+#include <utility>
+// -------------------------------------------------------------------------------------
+namespace mean {
+// -------------------------------------------------------------------------------------
+// Env
+// -------------------------------------------------------------------------------------
+MemEnv::~MemEnv() {
+   if (memory) {
+      munmap(memory, size);
+   }
+}
+void MemEnv::init(IoOptions options) {
+   ioOptions = std::move(options);
+   size = ioOptions.memorySize;
+   ensurem(size > 0, "the " + ioOptions.engine + " engine needs FILESIZE");
+   if (ioOptions.engine == "ramdisk") {
+      // not populated, pages are faulted in by the first write (init)
+      memory = (char*)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      posix_check(memory != MAP_FAILED, "ramdisk mmap failed");
+      madvise(memory, size, MADV_HUGEPAGE);
+   }
+   std::cout << ioOptions.engine << ": " << size / GIBI << " GiB latency: " << ioOptions.memoryLatencyNs << " ns" << std::endl;
+}
+MemChannel& MemEnv::getIoChannel(int channel) {
+   auto ch = channels.find(channel);
+   if (ch == channels.end()) {
+      ch = channels.insert({channel, std::make_unique<MemChannel>(memory, size, ioOptions)}).first;
+   }
+   return *ch->second;
+}
+void* MemEnv::allocIoMemory(size_t size, [[maybe_unused]] size_t align) {
+   void* bfs = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   posix_check(bfs != MAP_FAILED, "io memory mmap failed");
+   madvise(bfs, size, MADV_HUGEPAGE);
+   return bfs;
+}
+void* MemEnv::allocIoMemoryChecked(size_t size, size_t align) {
+   auto* mem = allocIoMemory(size, align);
+   null_checkm(mem, "Memory allocation failed");
+   return mem;
+}
+void MemEnv::freeIoMemory(void* ptr, size_t size) {
+   munmap(ptr, size);
+}
+DeviceInformation MemEnv::getDeviceInfo() {
+   DeviceInformation d;
+   d.devices.resize(1);
+   d.devices[0].id = 0;
+   d.devices[0].name = ioOptions.engine;
+   return d;
+}
+// -------------------------------------------------------------------------------------
+// Channel
+// -------------------------------------------------------------------------------------
+MemChannel::MemChannel(char* memory, u64 size, const IoOptions& ioOptions) : ioOptions(ioOptions), memory(memory), size(size), latencyTsc(nsToTSC(ioOptions.memoryLatencyNs)) {
+   request_stack.reserve(ioOptions.iodepth);
+}
+void MemChannel::copy(IoRequestType type, char* data, u64 offset, u64 len) {
+   if (!memory) {
+      return; // null
+   }
+   ensurem(offset + len <= size, "I/O beyond the end of the ramdisk: " + std::to_string(offset));
+   switch (type) {
+   case IoRequestType::Read:
+      std::memcpy(data, memory + offset, len);
+      break;
+   case IoRequestType::Write:
+      std::memcpy(memory + offset, data, len);
+      break;
+   default:
+      return;
+   }
+   copied += len;
+}
+// -------------------------------------------------------------------------------------
+void MemChannel::_push(RaidRequest<MemIoRequest>* req) {
+   request_stack.push_back(req);
+}
+int MemChannel::_submit() {
+   const u64 now = latencyTsc > 0 ? readTSC() : 0;
+   for (auto* req: request_stack) {
+      copy(req->base.type, req->base.buffer(), req->base.offset, req->base.len);
+      req->impl.due = now + latencyTsc;
+      inflight.push_back(req);
+   }
+   int submitted = request_stack.size();
+   request_stack.clear();
+   return submitted;
+}
+int MemChannel::_poll(int min) {
+   const u64 now = latencyTsc > 0 ? readTSC() : 0;
+   int done = 0;
+   while (!inflight.empty() && inflight.front()->impl.due <= now) {
+      auto* req = inflight.front();
+      inflight.pop_front();
+      req->base.innerCallback.callback(&req->base);
+      done++;
+   }
+   return done;
+}
+void MemChannel::_printSpecializedCounters(std::ostream& ss) {
+   ss << ioOptions.engine << ": copied: " << copied / MEBI << " MiB ";
+}
+void MemChannel::pushBlocking(IoRequestType type, char* data, u64 offset, u64 len, [[maybe_unused]] bool write_back) {
+   copy(type, data, offset, len);
+}
+// -------------------------------------------------------------------------------------
+} // namespace mean
+// -------------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+#pragma once
+// -------------------------------------------------------------------------------------
+#include "../DeviceInformation.hpp"
+#include "../IoOptions.hpp"
+#include "../IoRequest.hpp"
+// -------------------------------------------------------------------------------------
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace mean {
+// -------------------------------------------------------------------------------------
+// Engines without a device, to measure the overhead of iob itself and to run it anywhere.
+//   null:    requests complete on the next poll, no data is moved
+//   ramdisk: reads and writes copy from/to a (huge page) memory region
+// Both can add a fixed latency per request (IoOptions::memoryLatencyNs).
+// -------------------------------------------------------------------------------------
+class MemChannel;
+class MemEnv {
+   IoOptions ioOptions;
+   char* memory = nullptr; // ramdisk only
+   u64 size = 0;
+
+ public:
+   std::unordered_map<int, std::unique_ptr<MemChannel>> channels;
+   // -------------------------------------------------------------------------------------
+   ~MemEnv();
+   void init(IoOptions options);
+   int deviceCount() { return 1; }
+   u64 storageSize() { return size; }
+   MemChannel& getIoChannel(int channel);
+   // -------------------------------------------------------------------------------------
+   void* allocIoMemory(size_t size, size_t align);
+   void* allocIoMemoryChecked(size_t size, size_t align);
+   void freeIoMemory(void* ptr, size_t size = 0);
+   DeviceInformation getDeviceInfo();
+};
+// -------------------------------------------------------------------------------------
+struct MemIoRequest {
+   u64 due = 0; // tsc
+};
+class MemChannel {
+   IoOptions ioOptions;
+   char* memory;
+   u64 size;
+   u64 latencyTsc;
+   std::vector<RaidRequest<MemIoRequest>*> request_stack;
+   std::deque<RaidRequest<MemIoRequest>*> inflight; // constant latency: completes in submission order
+   u64 copied = 0;
+
+   void copy(IoRequestType type, char* data, u64 offset, u64 len);
+
+ public:
+   MemChannel(char* memory, u64 size, const IoOptions& ioOptions);
+   // -------------------------------------------------------------------------------------
+   void _push(RaidRequest<MemIoRequest>* req);
+   int _submit();
+   int _poll(int min = 0);
+   void _printSpecializedCounters(std::ostream& ss);
+   void pushBlocking(IoRequestType type, char* data, u64 offset, u64 len, bool write_back);
+   int registerBuffers(std::vector<std::pair<void*, uint64_t>>& buffers) {
+      return 0;
+   }
+};
+// -------------------------------------------------------------------------------------
+} // namespace mean
+// -------------------------------------------------------------------------------------
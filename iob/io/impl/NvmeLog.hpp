@@ -18,6 +18,7 @@
 #define C0_SMART_CLOUD_ATTR_LEN 0x200
 #define C0_SMART_CLOUD_ATTR_OPCODE 0xC0
 #define C0_GUID_LENGTH 16
+#define SMART_LOG_LEN 0x200
 
 namespace mean {
 enum {
@@ -57,10 +58,31 @@ enum {
    SCAO_LPV = 494,   /* Log page version */
    SCAO_LPG = 496,   /* Log page GUID */
 };
+// smart / health information log (02h)
+enum {
+   SMART_CW = 0,     /* Critical warning */
+   SMART_CT = 1,     /* Composite temperature (K) */
+   SMART_AS = 3,     /* Available spare */
+   SMART_PU = 5,     /* Percentage used */
+   SMART_DUR = 32,   /* Data units read (1000 * 512 bytes) */
+   SMART_DUW = 48,   /* Data units written */
+   SMART_HRC = 64,   /* Host read commands */
+   SMART_HWC = 80,   /* Host write commands */
+   SMART_CBT = 96,   /* Controller busy time (min) */
+   SMART_PC = 112,   /* Power cycles */
+   SMART_POH = 128,  /* Power on hours */
+   SMART_US = 144,   /* Unsafe shutdowns */
+   SMART_MDIE = 160, /* Media and data integrity errors */
+   SMART_NEL = 176,  /* Number of error information log entries */
+   SMART_WCTT = 192, /* Warning composite temperature time (min) */
+   SMART_CCTT = 196, /* Critical composite temperature time (min) */
+};
 
 class NvmeLog {
    bool ocpSupported = false;
+   bool smartSupported = false;
    alignas(8) std::array<uint8_t, sizeof(__u8) * C0_SMART_CLOUD_ATTR_LEN> log_data;
+   alignas(8) std::array<uint8_t, SMART_LOG_LEN> smart_data;
 
    uint64_t toBigEndian(uint64_t value) {
       if (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) {
@@ -97,21 +119,41 @@ class NvmeLog {
       }
       return resolved_path; // fallback: no change
    }
-   void loadOCPSmartLog() {
+   // admin fd of the controller of the benchmarked device, -1 if there is none (emulated, files)
+   static int openController() {
       std::string name = IoInterface::instance().getDeviceInfo().devices[0].name;
+      if (!std::filesystem::exists(name)) {
+         return -1;
+      }
       // name is like /blk/d1 or /dev/nvmeXn1
       // get the controler name, like /dev/nvmeX
       std::string resolved = resolve_symlink(name);
       std::string controller = extract_nvme_controller(resolved);
       //std::cout << "path: " << name << " resolved: " << resolved << " controller: " << controller << std::endl;
-      int fd = open(controller.c_str(), O_RDONLY | O_CLOEXEC);
-      if (fd >= 0) {
+      return open(controller.c_str(), O_RDONLY | O_CLOEXEC);
+   }
+   // fd: from openController, kept open by callers that load the logs repeatedly
+   bool loadOCPSmartLog(int fd) {
+      if (IoInterface::instance().ocpSmartLog(log_data.data(), log_data.size())) {
+         ocpSupported = true; // emulated drive
+      } else if (fd >= 0) {
          int ret = nvme_get_log_simple(fd, (nvme_cmd_get_log_lid)C0_SMART_CLOUD_ATTR_OPCODE, C0_SMART_CLOUD_ATTR_LEN, &log_data); // NOLINT
          ocpSupported = (ret == 0);
-         close(fd);
       } else {
          ocpSupported = false;
       }
+      return ocpSupported;
+   }
+   bool loadSmartLog(int fd) {
+      smartSupported = fd >= 0 && nvme_get_log_simple(fd, NVME_LOG_LID_SMART, SMART_LOG_LEN, smart_data.data()) == 0; // NOLINT
+      return smartSupported;
+   }
+   void loadOCPSmartLog() {
+      int fd = openController();
+      loadOCPSmartLog(fd);
+      if (fd >= 0) {
+         close(fd);
+      }
    }
    uint64_t physicalMediaUnitsWrittenBytes() {
       if (!ocpSupported) {
@@ -145,6 +187,28 @@ class NvmeLog {
    uint8_t currentThrottlingStatus() {
       return (__u8)log_data[SCAO_CTS];
    }
+   // smart log, 128 bit counters: the low 64 bits
+   bool hasSmart() const {
+      return smartSupported;
+   }
+   uint64_t smart64(int offset) {
+      return toBigEndian(*(uint64_t*)&smart_data[offset]);
+   }
+   uint32_t smart32(int offset) {
+      return toBigEndian(*(uint32_t*)&smart_data[offset]);
+   }
+   uint8_t criticalWarning() {
+      return smart_data[SMART_CW];
+   }
+   uint16_t temperatureKelvin() {
+      return smart_data[SMART_CT] | (smart_data[SMART_CT + 1] << 8);
+   }
+   uint8_t availableSpare() {
+      return smart_data[SMART_AS];
+   }
+   uint8_t percentageUsed() {
+      return smart_data[SMART_PU];
+   }
 };
 // NOLINTEND(modernize-*,performance-*)
 }; // namespace mean
@@ -0,0 +1,183 @@
+#include "SsdSimImpl.hpp"
+// -------------------------------------------------------------------------------------
+#include "Exceptions.hpp"
+#include "NvmeLog.hpp"
+#include "Time.hpp"
+#include "Units.hpp"
+// -------------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+// -------------------------------------------------------------------------------------
+namespace mean {
+// -------------------------------------------------------------------------------------
+// Env
+// -------------------------------------------------------------------------------------
+SsdSimEnv::~SsdSimEnv() {
+   if (ioOptions.simState.empty() || !ssd) {
+      return;
+   }
+   // the drive survives the run, like a real one between two iob runs
+   std::string tmp = ioOptions.simState + ".tmp";
+   std::ofstream out(tmp, std::ios::binary);
+   ssd->save(out);
+   gc->save(out);
+   out.close();
+   std::filesystem::rename(tmp, ioOptions.simState);
+   std::cout << "ssdsim: saved " << ioOptions.simState << std::endl;
+}
+void SsdSimEnv::init(IoOptions options) {
+   ioOptions = std::move(options);
+   ensurem(ioOptions.memorySize > 0, "the ssdsim engine needs FILESIZE");
+   ensurem(ioOptions.simFill > 0 && ioOptions.simFill < 1, "ssdsim: fill has to be in (0, 1)");
+   // physical capacity: the logical size plus over-provisioning, rounded up to whole erase blocks
+   u64 capacity = ioOptions.memorySize / ioOptions.simFill;
+   capacity += ioOptions.simEraseSize - 1;
+   capacity -= capacity % ioOptions.simEraseSize;
+   ssd = std::make_unique<SSD>(capacity, ioOptions.simEraseSize, ioOptions.simPageSize, ioOptions.simFill);
+   int k = 0;
+   bool twoR = ioOptions.simGC == "greedy-s2r";
+   if (ioOptions.simGC.starts_with("greedy-k")) {
+      k = std::stoi(ioOptions.simGC.substr(8));
+   } else {
+      ensurem(ioOptions.simGC == "greedy" || twoR, "ssdsim: unknown gc " + ioOptions.simGC + " (greedy, greedy-kN, greedy-s2r)");
+   }
+   gc = std::make_unique<GreedyGC>(*ssd, k, twoR);
+   if (!ioOptions.simState.empty() && std::filesystem::exists(ioOptions.simState)) {
+      std::ifstream in(ioOptions.simState, std::ios::binary);
+      if (ssd->load(in)) {
+         gc->load(in);
+         restored = true;
+         std::cout << "ssdsim: loaded " << ioOptions.simState << std::endl;
+      } else {
+         std::cout << "ssdsim: " << ioOptions.simState << " has a different geometry, starting with an empty drive" << std::endl;
+         ssd = std::make_unique<SSD>(capacity, ioOptions.simEraseSize, ioOptions.simPageSize, ioOptions.simFill);
+         gc = std::make_unique<GreedyGC>(*ssd, k, twoR);
+      }
+   }
+   dieBusyUntil.assign(ioOptions.simDies, 0);
+   readTsc = nsToTSC(ioOptions.simReadNs);
+   programTsc = nsToTSC(ioOptions.simProgramNs);
+   eraseTsc = nsToTSC(ioOptions.simEraseNs);
+   ssd->printInfo();
+   std::cout << "ssdsim: gc: " << gc->name() << " dies: " << ioOptions.simDies << " read: " << ioOptions.simReadNs << " ns program: " << ioOptions.simProgramNs
+             << " ns erase: " << ioOptions.simEraseNs << " ns" << std::endl;
+}
+SsdSimChannel& SsdSimEnv::getIoChannel(int channel) {
+   auto ch = channels.find(channel);
+   if (ch == channels.end()) {
+      ch = channels.insert({channel, std::make_unique<SsdSimChannel>(*this, ioOptions)}).first;
+   }
+   return *ch->second;
+}
+void* SsdSimEnv::allocIoMemory(size_t size, [[maybe_unused]] size_t align) {
+   void* bfs = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   posix_check(bfs != MAP_FAILED, "io memory mmap failed");
+   madvise(bfs, size, MADV_HUGEPAGE);
+   return bfs;
+}
+void* SsdSimEnv::allocIoMemoryChecked(size_t size, size_t align) {
+   auto* mem = allocIoMemory(size, align);
+   null_checkm(mem, "Memory allocation failed");
+   return mem;
+}
+void SsdSimEnv::freeIoMemory(void* ptr, size_t size) {
+   munmap(ptr, size);
+}
+DeviceInformation SsdSimEnv::getDeviceInfo() {
+   DeviceInformation d;
+   d.devices.resize(1);
+   d.devices[0].id = 0;
+   d.devices[0].name = "ssdsim";
+   return d;
+}
+u64 SsdSimEnv::execute(IoRequestType type, u64 offset, u64 len, u64 now) {
+   const u64 pageSize = ssd->pageSizeBytes;
+   ensurem(offset % pageSize == 0 && len % pageSize == 0, "ssdsim: requests have to be aligned to the page size " + std::to_string(pageSize));
+   std::lock_guard<std::mutex> lock(mutex);
+   u64 done = now;
+   for (u64 page = offset / pageSize; page < (offset + len) / pageSize; page++) {
+      ensurem(page < ssd->logicalPages, "ssdsim: I/O beyond the end of the drive: " + std::to_string(offset));
+      u64 cost = 0;
+      switch (type) {
+      case IoRequestType::Write: {
+         u64 physWrites = ssd->physWrites();
+         u64 erases = ssd->erases();
+         gc->writePage(page);
+         u64 relocated = ssd->physWrites() - physWrites - 1;
+         mediaReads += relocated;
+         cost = programTsc * (1 + relocated) + readTsc * relocated + eraseTsc * (ssd->erases() - erases);
+         break;
+      }
+      case IoRequestType::Read:
+         mediaReads++;
+         cost = readTsc;
+         break;
+      case IoRequestType::Trim:
+         ssd->trimPage(page);
+         break;
+      default:
+         break;
+      }
+      u64& busy = dieBusyUntil[page % dieBusyUntil.size()];
+      busy = std::max(busy, now) + cost;
+      done = std::max(done, busy);
+   }
+   return done;
+}
+bool SsdSimEnv::ocpSmartLog(uint8_t* log, size_t len) {
+   std::lock_guard<std::mutex> lock(mutex);
+   std::memset(log, 0, len);
+   u64 written = ssd->physWrites() * ssd->pageSizeBytes;
+   u64 read = mediaReads * ssd->pageSizeBytes;
+   uint32_t maxErase = ssd->eraseMax();
+   uint32_t minErase = ssd->eraseMin();
+   std::memcpy(log + SCAO_PMUW, &written, sizeof(written));
+   std::memcpy(log + SCAO_PMUR, &read, sizeof(read));
+   std::memcpy(log + SCAO_MXUDEC, &maxErase, sizeof(maxErase));
+   std::memcpy(log + SCAO_MNUDEC, &minErase, sizeof(minErase));
+   log[SCAO_PFB] = gc->freeBlockCount() * 100 / ssd->blockCount;
+   return true;
+}
+// -------------------------------------------------------------------------------------
+// Channel
+// -------------------------------------------------------------------------------------
+SsdSimChannel::SsdSimChannel(SsdSimEnv& env, const IoOptions& ioOptions) : env(env) {
+   request_stack.reserve(ioOptions.iodepth);
+}
+void SsdSimChannel::_push(Request* req) {
+   request_stack.push_back(req);
+}
+int SsdSimChannel::_submit() {
+   const u64 now = readTSC();
+   for (auto* req: request_stack) {
+      req->impl.due = env.execute(req->base.type, req->base.offset, req->base.len, now);
+      inflight.emplace(req->impl.due, req);
+   }
+   int submitted = request_stack.size();
+   request_stack.clear();
+   return submitted;
+}
+int SsdSimChannel::_poll(int min) {
+   const u64 now = readTSC();
+   int done = 0;
+   while (!inflight.empty() && inflight.top().first <= now) {
+      auto* req = inflight.top().second;
+      inflight.pop();
+      req->base.innerCallback.callback(&req->base);
+      done++;
+   }
+   return done;
+}
+void SsdSimChannel::_printSpecializedCounters(std::ostream& ss) {
+   ss << "ssdsim: ";
+}
+void SsdSimChannel::pushBlocking(IoRequestType type, [[maybe_unused]] char* data, u64 offset, u64 len, [[maybe_unused]] bool write_back) {
+   env.execute(type, offset, len, readTSC());
+}
+// -------------------------------------------------------------------------------------
+} // namespace mean
+// -------------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+#pragma once
+// -------------------------------------------------------------------------------------
+#include "../DeviceInformation.hpp"
+#include "../IoOptions.hpp"
+#include "../IoRequest.hpp"
+// -------------------------------------------------------------------------------------
+#include "Greedy.hpp"
+#include "SSD.hpp"
+// -------------------------------------------------------------------------------------
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+// -------------------------------------------------------------------------------------
+namespace mean {
+// -------------------------------------------------------------------------------------
+// Emulated drive: the ftl of the gc simulator (SSD + GreedyGC) behind the iob request stack.
+// Writes are mapped by the gc, no data is stored. Timing model: the logical pages are striped over
+// dies, a die executes one page at a time. A page write costs a program, plus a read and a program
+// per page relocated by the gc it triggers and an erase per erased block, all on the die of the written page
+// (a real drive spreads the relocations over the dies of the victim block). A request completes when
+// its last page is done. Wear and write amplification are reported through the ocp smart log fields.
+// -------------------------------------------------------------------------------------
+class SsdSimChannel;
+class SsdSimEnv {
+   IoOptions ioOptions;
+   std::unique_ptr<SSD> ssd;
+   std::unique_ptr<GreedyGC> gc;
+   std::mutex mutex; // all channels share the drive
+   std::vector<u64> dieBusyUntil; // tsc
+   u64 readTsc = 0;
+   u64 programTsc = 0;
+   u64 eraseTsc = 0;
+   u64 mediaReads = 0; // pages, host reads and gc relocations
+   bool restored = false; // state loaded from simState
+
+ public:
+   std::unordered_map<int, std::unique_ptr<SsdSimChannel>> channels;
+   // -------------------------------------------------------------------------------------
+   ~SsdSimEnv();
+   void init(IoOptions options);
+   int deviceCount() { return 1; }
+   u64 storageSize() { return ssd->logicalPages * ssd->pageSizeBytes; }
+   SsdSimChannel& getIoChannel(int channel);
+   // -------------------------------------------------------------------------------------
+   void* allocIoMemory(size_t size, size_t align);
+   void* allocIoMemoryChecked(size_t size, size_t align);
+   void freeIoMemory(void* ptr, size_t size = 0);
+   DeviceInformation getDeviceInfo();
+   // -------------------------------------------------------------------------------------
+   // runs the request on the drive, returns its completion time (tsc)
+   u64 execute(IoRequestType type, u64 offset, u64 len, u64 now);
+   bool ocpSmartLog(uint8_t* log, size_t len);
+   bool initialized() { return restored; }
+};
+// -------------------------------------------------------------------------------------
+struct SsdSimIoRequest {
+   u64 due = 0; // tsc
+};
+class SsdSimChannel {
+   using Request = RaidRequest<SsdSimIoRequest>;
+   using Due = std::pair<u64, Request*>;
+   SsdSimEnv& env;
+   std::vector<Request*> request_stack;
+   std::priority_queue<Due, std::vector<Due>, std::greater<>> inflight; // earliest completion first
+
+ public:
+   SsdSimChannel(SsdSimEnv& env, const IoOptions& ioOptions);
+   // -------------------------------------------------------------------------------------
+   void _push(Request* req);
+   int _submit();
+   int _poll(int min = 0);
+   void _printSpecializedCounters(std::ostream& ss);
+   void pushBlocking(IoRequestType type, char* data, u64 offset, u64 len, bool write_back);
+   int registerBuffers(std::vector<std::pair<void*, uint64_t>>& buffers) {
+      return 0;
+   }
+};
+// -------------------------------------------------------------------------------------
+} // namespace mean
+// -------------------------------------------------------------------------------------
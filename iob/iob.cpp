@@ -1,8 +1,12 @@
 // -------------------------------------------------------------------------------------
 #include "Env.hpp"
+#include "IoTraceWriter.hpp"
 #include "PageState.hpp"
 #include "PatternGen.hpp"
 #include "RequestGenerator.hpp"
+#include "SmartCollector.hpp"
+#include "StatsLogger.hpp"
+#include "Sweep.hpp"
 #include "ThreadBase.hpp"
 #include "Time.hpp"
 #include "Units.hpp"
@@ -17,10 +21,10 @@
 #include <iomanip>
 #include <thread>
 
-static void initializeSSDIfNecessary(mean::FileState& fileState, long maxPage, long bufSize, const std::string& init, int iodepth) {
+static void initializeSSDIfNecessary(mean::FileState& fileState, long maxPage, long bufSize, const std::string& init, int iodepth, int channel, bool dataChecks) {
    using namespace mean;
    // check if necessary
-   IoChannel& ioChannel = IoInterface::instance().getIoChannel(0);
+   IoChannel& ioChannel = IoInterface::instance().getIoChannel(channel);
 
    int initBufSize = 512 * 1024; // FIXME: this might not work with SPDK on some SSDs, check for max transfer size and use that.
    char* buf = (char*)IoInterface::instance().allocIoMemoryChecked(initBufSize + 512, 512);
@@ -30,9 +34,17 @@ static void initializeSSDIfNecessary(mean::FileState& fileState, long maxPage, l
    bool forceInit = init == "yes";
    bool autoInit = init == "auto";
    bool disableCheck = init == "disable" || init == "no";
+   if (!dataChecks) {
+      // the engine keeps no data (null, ssdsim): yes/auto only write the device once, auto not a restored drive
+      if (autoInit && IoInterface::instance().initialized()) {
+         std::cout << "init: drive state restored, skipped" << std::endl;
+      } else {
+         forceInit |= autoInit;
+      }
+   }
 
    int iniDoneCheck = true;
-   if (!forceInit && !disableCheck) {
+   if (!forceInit && !disableCheck && dataChecks) {
       // just a heurisitc: check first and last page
       // TODO: refactor: move this to FileState?
       auto offset = 0 * bufSize;
@@ -72,13 +84,17 @@ static void initializeSSDIfNecessary(mean::FileState& fileState, long maxPage, l
          pgOptions.pageSize = initOptions.bs;
          pgOptions.patternString = "sequential";
          iob::PatternGen patternGen(pgOptions);
-         RequestGenerator init("", initOptions, IoInterface::instance().getIoChannel(0), 0, time, patternGen, fileState);
+         RequestGenerator init("", initOptions, ioChannel, 0, time, patternGen, fileState);
          init.runIo();
          std::cout << std::endl;
          auto duration = getSeconds() - start;
          std::cout << "init done: " << iniOps * initBufSize / duration / MEBI << "MiB/s ops: " << iniOps << " time: " << duration << std::endl
                    << std::flush;
       }
+      if (!dataChecks) {
+         IoInterface::instance().freeIoMemory(buf);
+         return;
+      }
       // check again
       fileState.resetBufferChecks(buf, bufSize);
       ioChannel.pushBlocking(IoRequestType::Read, buf, 0 * bufSize, bufSize);
@@ -113,7 +129,7 @@ class RequestGeneratorThread : public mean::ThreadBase {
    }
 };
 
-std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOptions(int argc, char** argv) {
+std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options, mean::SweepOptions> loadOptions(int argc, char** argv) {
    CLI::App app{"IO Benchmark Tool"};
 
    // IO Options
@@ -125,6 +141,24 @@ std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOpti
    app.add_option("--iodepth", ioOptions.iodepth, "IO depth")->envname("IO_DEPTH")->default_val(128);
    app.add_flag("--ioupoll", ioOptions.ioUringPollMode, "Enable io_uring poll mode")->envname("IOUPOLL");
    app.add_flag("--ioupt", ioOptions.ioUringNVMePassthrough, "Enable io_uring passthrough")->envname("IOUPT");
+   app.add_flag("--ioufixed", ioOptions.ioUringFixedBuffers, "Enable io_uring registered buffers and files")->envname("IOUFIXED");
+   app.add_flag("--iousingle", ioOptions.ioUringSingleIssuer, "Enable io_uring single issuer")->envname("IOUSINGLE");
+   app.add_flag("--ioudefer", ioOptions.ioUringDeferTaskrun, "Enable io_uring defer taskrun (implies single issuer)")->envname("IOUDEFER");
+   app.add_flag("--ioucoop", ioOptions.ioUringCoopTaskrun, "Enable io_uring cooperative taskrun")->envname("IOUCOOP");
+   app.add_flag("--iouregring", ioOptions.ioUringRegisterRingFd, "Enable io_uring registered ring fd")->envname("IOUREGRING");
+   app.add_option("--memlat", ioOptions.memoryLatencyNs, "null/ramdisk engine: latency per request in ns")->envname("MEMLAT")->default_val(0);
+   std::string simPageStr = "4K";
+   std::string simEraseStr = "8M";
+   app.add_option("--simpage", simPageStr, "ssdsim engine: page size")->envname("SIMPAGE")->default_val("4K");
+   app.add_option("--simerase", simEraseStr, "ssdsim engine: erase block size")->envname("SIMERASE")->default_val("8M");
+   app.add_option("--simfill", ioOptions.simFill, "ssdsim engine: logical / physical capacity")->envname("SIMFILL")->default_val(0.9);
+   app.add_option("--simgc", ioOptions.simGC, "ssdsim engine: gc (greedy, greedy-kN, greedy-s2r)")->envname("SIMGC")->default_val("greedy");
+   app.add_option("--simdies", ioOptions.simDies, "ssdsim engine: dies that work in parallel")->envname("SIMDIES")->default_val(64);
+   app.add_option("--simreadns", ioOptions.simReadNs, "ssdsim engine: page read time in ns")->envname("SIMREADNS")->default_val(60000);
+   app.add_option("--simprogramns", ioOptions.simProgramNs, "ssdsim engine: page program time in ns")->envname("SIMPROGRAMNS")->default_val(200000);
+   app.add_option("--simerasens", ioOptions.simEraseNs, "ssdsim engine: block erase time in ns")->envname("SIMERASENS")->default_val(3000000);
+   app.add_option("--simstate", ioOptions.simState, "ssdsim engine: file that keeps the drive between runs")->envname("SIMSTATE");
+   app.add_option("--iouwait", ioOptions.ioUringWaitAfter, "io_uring: empty polls before blocking for a completion, 0: never block")->envname("IOUWAIT")->default_val(0);
 
    // JobOptions
    mean::JobOptions jobOptions;
@@ -151,7 +185,16 @@ std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOpti
 
    app.add_option("--rate", jobOptions.totalRate, "Total IO rate")->envname("RATE")->default_val(0);
    app.add_option("--exprate", jobOptions.exponentialRate, "Use exponential rate")->envname("EXPRATE")->default_val(1);
-
+   mean::SweepOptions sweepOptions;
+   app.add_option("--sweep", sweepOptions.spec, "Latency vs. throughput curve in one run: rate:10k,20k,... rate:10k..400k+10k iodepth:1..256*2 (iob-sweep csv)")->envname("SWEEP");
+   app.add_option("--sweepwindow", sweepOptions.window, "sweep: seconds for the steady state check and the measurement of a step")->envname("SWEEPWINDOW")->default_val(5);
+   app.add_option("--sweepwarmup", sweepOptions.maxWarmup, "sweep: max seconds to wait for steady state")->envname("SWEEPWARMUP")->default_val(60);
+   app.add_option("--sweepcv", sweepOptions.cv, "sweep: steady when stddev/mean of the IOPS over the window is below")->envname("SWEEPCV")->default_val(0.05);
+   app.add_option("--sweepp99", sweepOptions.p99Limit, "sweep: stop once p99 is above (us)")->envname("SWEEPP99")->default_val(0);
+   app.add_flag("--openloop", jobOptions.openLoop, "With --rate: measure latency from the intended issue time, keep arrivals that find no free request")->envname("OPENLOOP");
+
+   app.add_option("--smartinterval", jobOptions.smartIntervalMs, "Interval of the smart/ocp log collector in ms (iob-smartlog csv)")->envname("SMARTINTERVAL")->default_val(1000);
+   app.add_flag("--iotrace", jobOptions.enableIoTracing, "Stream a binary trace of every I/O to iob-trace-<prefix>.bin (traces/iobtrace converts it)")->envname("IOTRACE");
    app.add_flag("--long_console_output", jobOptions.longConsoleOutput, "Enable long output in console")->envname("LONG_CONSOLE_OUTPUT");
 
    auto pgOptions = iob::PatternGen::setupCliOptions(app);
@@ -161,9 +204,22 @@ std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOpti
    } catch (const CLI::ParseError& e) {
       std::exit(app.exit(e));
    }
+   if (!sweepOptions.spec.empty()) {
+      sweepOptions.parse();
+      if (sweepOptions.rate) {
+         jobOptions.totalRate = sweepOptions.steps[0];
+         jobOptions.openLoop = true; // a rate sweep is about the response time
+      } else {
+         ioOptions.iodepth = std::max<int>(ioOptions.iodepth, *std::ranges::max_element(sweepOptions.steps));
+      }
+   }
 
    jobOptions.filename = ioOptions.path;
    ioOptions.channelCount = jobOptions.threads;
+   if (ioOptions.ioUringSingleIssuer || ioOptions.ioUringDeferTaskrun || ioOptions.ioUringRegisterRingFd) {
+      // init on its own ring, a single issuer ring only accepts submissions from one thread, a registered fd only works on one
+      ioOptions.channelCount++;
+   }
 
    long bufSize = getBytesFromString(bsStr);
    if (bufSize % 512 != 0) {
@@ -173,6 +229,12 @@ std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOpti
       std::cout << "BS is not a multiple of 4096. Are you sure that is what you want?" << std::endl;
    }
 
+   if (ioOptions.emulated()) {
+      ioOptions.memorySize = filesizeStr.empty() ? 0 : getBytesFromString(filesizeStr);
+      ioOptions.simPageSize = getBytesFromString(simPageStr);
+      ioOptions.simEraseSize = getBytesFromString(simEraseStr);
+   }
+
    mean::IoInterface::initInstance(ioOptions);
    jobOptions.totalfilesize = filesizeStr.empty() ? mean::IoInterface::instance().storageSize() : getBytesFromString(filesizeStr);
 
@@ -205,6 +267,9 @@ std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOpti
    std::cout << "init: " << jobOptions.init << ", crc: " << jobOptions.crc << ", random: " << jobOptions.randomData << std::endl;
    std::cout << "ionengine: " << ioOptions.engine;
    std::cout << " iodepth: " << ioOptions.iodepth;
+   std::cout << " fixed: " << ioOptions.ioUringFixedBuffers;
+   std::cout << " single: " << ioOptions.ioUringSingleIssuer << " defer: " << ioOptions.ioUringDeferTaskrun << " coop: " << ioOptions.ioUringCoopTaskrun;
+   std::cout << " regring: " << ioOptions.ioUringRegisterRingFd << " wait: " << ioOptions.ioUringWaitAfter;
    std::cout << " bs: " << bufSize << std::endl;
 
    if (ioSize == 0) {
@@ -214,12 +279,15 @@ std::tuple<mean::JobOptions, mean::IoOptions, iob::PatternGen::Options> loadOpti
    jobOptions.bs = bufSize;
    jobOptions.iodepth = ioOptions.iodepth;
    jobOptions.io_size = ioSize / jobOptions.threads;
+   if (!sweepOptions.spec.empty()) {
+      jobOptions.io_size = 0; // the sweep ends the run
+   }
    jobOptions.rateLimit = jobOptions.totalRate / jobOptions.threads;
-   jobOptions.disableChecks = jobOptions.init == "disable";
+   jobOptions.disableChecks = jobOptions.init == "disable" || !ioOptions.storesData();
 
    iob::PatternGen::cliOptionsParsed(*pgOptions, jobOptions.filesize / jobOptions.bs, jobOptions.bs);
 
-   return {jobOptions, ioOptions, *pgOptions};
+   return {jobOptions, ioOptions, *pgOptions, sweepOptions};
 }
 
 // NOLINTBEGIN(bugprone-exception-escape)
@@ -230,18 +298,18 @@ int main(int argc, char** argv) {
    JobOptions& jobOptions = std::get<0>(options);
    IoOptions& ioOptions = std::get<1>(options);
    iob::PatternGen::Options& pgOptions = std::get<2>(options);
+   SweepOptions& sweepOptions = std::get<3>(options);
 
    iob::PatternGen::printPatternHistorgram(pgOptions);
    iob::PatternGen patternGen(pgOptions);
 
    mean::FileState fileState{(jobOptions.maxPage + 1) * jobOptions.bs, jobOptions.crc, jobOptions.randomData};
-   initializeSSDIfNecessary(fileState, jobOptions.maxPage, jobOptions.bs, jobOptions.init, ioOptions.iodepth);
+   int initChannel = ioOptions.channelCount > jobOptions.threads ? jobOptions.threads : 0;
+   initializeSSDIfNecessary(fileState, jobOptions.maxPage, jobOptions.bs, jobOptions.init, ioOptions.iodepth, initChannel, ioOptions.storesData());
 
    jobOptions.logHash = getTimeStampStr();
    std::ofstream dump;
    dump.open("iob-dump-" + jobOptions.statsPrefix + ".csv", std::ios_base::app);
-   IoTrace::IoStat::dumpIoStatHeader(dump, "iodepth, bs, io_alignment,");
-   dump << std::endl;
 
    std::cout << jobOptions.print();
 
@@ -276,15 +344,39 @@ int main(int argc, char** argv) {
          threadVec.emplace_back(std::move(std::make_unique<RequestGeneratorThread>(jobOptions, thr, time, patternGen, fileState)));
       }
    }
+   StatsLogger statsLogger;
+   for (auto& t: threadVec) {
+      statsLogger.add(t->gen);
+   }
+   statsLogger.start();
+   std::unique_ptr<IoTraceWriter> ioTraceWriter;
+   if (jobOptions.enableIoTracing) {
+      std::vector<RequestGenerator*> gens;
+      for (auto& t: threadVec) {
+         gens.push_back(&t->gen);
+      }
+      ioTraceWriter = std::make_unique<IoTraceWriter>(jobOptions, gens);
+      ioTraceWriter->start();
+   }
    std::this_thread::sleep_for(std::chrono::milliseconds(1));
    for (auto& t: threadVec) {
       t->start();
    }
+   std::unique_ptr<Sweep> sweep;
+   if (!sweepOptions.spec.empty()) {
+      std::vector<RequestGenerator*> gens;
+      for (size_t i = jobOptions.latencyThread ? 1 : 0; i < threadVec.size(); i++) { // not the latency probe
+         gens.push_back(&threadVec[i]->gen);
+      }
+      sweep = std::make_unique<Sweep>(sweepOptions, jobOptions, gens);
+   }
    long maxRead = 0;
    if (jobOptions.runtimeLimit > 0) {
       std::cout << "runtime: " << jobOptions.runtimeLimit << " s" << std::endl;
    }
    auto start = getSeconds();
+   SmartCollector smartCollector(jobOptions.statsPrefix, jobOptions.logHash, jobOptions.smartIntervalMs, time, start);
+   smartCollector.start();
    // std::this_thread::sleep_for(std::chrono::seconds(1));
    long lastOCPUpdateTime = -1;
    long prevPhyWrites = -1;
@@ -292,8 +384,7 @@ int main(int argc, char** argv) {
    long prevHostWrites = -1;
    while (true) {
       auto now = getSeconds();
-      NvmeLog nvmeLog;
-      nvmeLog.loadOCPSmartLog();
+      const SmartSample smart = smartCollector.latest();
       long sumReads = 0;
       long sumWrites = 0;
       long sumReadsPS = 0;
@@ -337,9 +428,6 @@ int main(int argc, char** argv) {
          header << "wa";
          if (!iobLogExists) {
             iobLog << header.str() << endl;
-            string s = "echo \"prefix,time,hash,type,data\" >> iob-smart-" + jobOptions.statsPrefix + ".csv";
-            int sys = system(s.c_str());
-            assert(sys == 0);
          }
          if (jobOptions.longConsoleOutput) {
             std::cout << header.str() << std::endl;
@@ -359,8 +447,8 @@ int main(int argc, char** argv) {
       ss << "," << sumWrites << "," << sumReads;
       ss << "," << sumWritesPS << "," << sumReadsPS;
       ss << "," << sumWritesPS * jobOptions.bs / MEBI << "," << sumReadsPS * jobOptions.bs / MEBI;
-      long currentTotPhyWrites = nvmeLog.physicalMediaUnitsWrittenBytes();
-      long currentTotPhyReads = nvmeLog.physicalMediaUnitsReadBytes();
+      long currentTotPhyWrites = smart.phyWrites;
+      long currentTotPhyReads = smart.phyReads;
       long thisSecondPhyWrites = 0;
       long thisSecondPhyReads = 0;
       double thisSecondWA = 0;
@@ -380,9 +468,9 @@ int main(int argc, char** argv) {
       ss << "," << currentTotPhyReads;
       ss << "," << thisSecondPhyWrites / MEBI;
       ss << "," << thisSecondPhyReads / MEBI;
-      ss << "," << (int)nvmeLog.percentFreeBlocks();
-      ss << "," << nvmeLog.softECCError() << "," << nvmeLog.unalignedIO() << "," << nvmeLog.maxUserDataEraseCount();
-      ss << "," << nvmeLog.minUserDataEraseCount() << "," << (int)nvmeLog.currentThrottlingStatus();
+      ss << "," << (int)smart.percentFreeBlocks;
+      ss << "," << smart.softEcc << "," << smart.unalignedIo << "," << smart.maxEraseCount;
+      ss << "," << smart.minEraseCount << "," << (int)smart.throttling;
       ss << "," << thisSecondWA;
       iobLog << ss.str() << endl;
       if (jobOptions.longConsoleOutput) {
@@ -395,26 +483,10 @@ int main(int argc, char** argv) {
          cout << std::endl;
       }
 
-      string smartLine = jobOptions.statsPrefix + "," + to_string(time) + "," + jobOptions.logHash + "";
-      std::string controller_filename = mean::NvmeLog::extract_nvme_controller(mean::NvmeLog::resolve_symlink(jobOptions.filename));
-      string sysSmart =
-          "echo -n \"" + smartLine + ",smart,\"                                >> iob-smart-" + jobOptions.statsPrefix + ".csv" +
-          " ; sudo nvme smart-log         " + controller_filename + " --output-format=json | tr -d '\\n'      >> iob-smart-" + jobOptions.statsPrefix + ".csv" +
-          " ; echo "
-          "                                                                          >> iob-smart-" +
-          jobOptions.statsPrefix + ".csv";
-      string sysOCP =
-          "echo -n \"" + smartLine + ",ocp,\"                                 >> iob-smart-" + jobOptions.statsPrefix + ".csv" +
-          " ; sudo nvme ocp smart-add-log " + controller_filename + " --output-format=json  2> /dev/null | tr -d '\\n'      >> iob-smart-" + jobOptions.statsPrefix + ".csv" +
-          " ; echo "
-          "                                                                          >> iob-smart-" +
-          jobOptions.statsPrefix + ".csv";
-      int sys = system(sysSmart.c_str());
-      assert(sys == 0);
-      sys = system(sysOCP.c_str());
-      assert(sys == 0);
-      // cout << sys << endl;
 
+      if (sweep && !sweep->tick(time, sumReadsPS, sumWritesPS, currentTotPhyWrites, sumWrites)) {
+         break;
+      }
       now = getSeconds();
       bool oneDone = false;
       for (auto& t: threadVec) {
@@ -433,23 +505,29 @@ int main(int argc, char** argv) {
    for (auto& t: threadVec) {
       t->stop();
    }
+   smartCollector.stop();
+   smartCollector.join();
 
    u64 reads = 0;
    u64 writes = 0;
-   double ravg = 0;
-   u64 r50p = 0;
-   u64 r99p = 0;
-   u64 r99p9 = 0;
-   u64 w50p = 0;
-   double wavg = 0;
-   u64 w99p = 0;
-   u64 w99p9 = 0;
+   LogHist readHist; // all threads
+   LogHist writeHist;
+   LogHist readResponseHist;
+   LogHist writeResponseHist;
+   u64 missedSchedule = 0;
    u64 rTotalTime = 0;
    u64 wTotalTime = 0;
    double totalTime = 0;
+   double cpuTime = 0;
    for (auto& t: threadVec) {
       t->join();
    }
+   statsLogger.stop();
+   statsLogger.join();
+   if (ioTraceWriter) {
+      ioTraceWriter->stop();
+      ioTraceWriter->join();
+   }
    std::ofstream patDump;
    patDump.open("iob-patdump-" + jobOptions.statsPrefix + ".csv", std::ios_base::app);
    RequestGenerator::dumpPatternAccessHeader(patDump, "");
@@ -471,17 +549,14 @@ int main(int argc, char** argv) {
       reads += t->gen.stats.reads;
       writes += t->gen.stats.writes;
       totalTime += t->gen.stats.time;
-      r50p += t->gen.stats.readHist.getPercentile(50);
-      r99p += t->gen.stats.readHist.getPercentile(99);
-      r99p9 += t->gen.stats.readHist.getPercentile(99.9);
-      w50p += t->gen.stats.writeHist.getPercentile(50);
-      w99p += t->gen.stats.writeHist.getPercentile(99);
-      w99p9 += t->gen.stats.writeHist.getPercentile(99.9);
-      ravg += t->gen.stats.readHist.getAverage();
-      wavg += t->gen.stats.writeHist.getAverage();
+      cpuTime += t->gen.stats.cpuTime;
+      readHist += t->gen.stats.readHist;
+      writeHist += t->gen.stats.writeHist;
+      readResponseHist += t->gen.stats.readResponseHist;
+      writeResponseHist += t->gen.stats.writeResponseHist;
+      missedSchedule += t->gen.stats.missedSchedule;
       rTotalTime += t->gen.stats.readTotalTime;
       wTotalTime += t->gen.stats.writeTotalTime;
-      t->gen.ioTrace.dumpIoTrace(dump, std::to_string(jobOptions.iodepth) + "," + std::to_string(jobOptions.bs) + "," + std::to_string(0 /*alignment compatibility*/) + ",");
       t->gen.aggregatePatternAccess(accessHist);
       t->gen.samplePatternAccess(sampleLocs, accesses);
       // t->gen.dumpPatternAccess("patterDump:: ", cout);
@@ -504,19 +579,25 @@ int main(int argc, char** argv) {
    cout << endl;
    */
    totalTime /= jobOptions.threads;
-   ravg /= jobOptions.threads;
-   r50p /= jobOptions.threads;
-   r99p /= jobOptions.threads;
-   r99p9 /= jobOptions.threads;
-   w50p /= jobOptions.threads;
-   wavg /= jobOptions.threads;
-   w99p /= jobOptions.threads;
-   w99p9 /= jobOptions.threads;
+   // percentiles of all ios, not the average of the per-thread percentiles
+   const double percentiles[] = {50, 99, 99.9};
+   u64 rp[3];
+   u64 wp[3];
+   readHist.getPercentiles(percentiles, rp, 3);
+   writeHist.getPercentiles(percentiles, wp, 3);
+   const double ravg = readHist.getAverage() / 1e3;
+   const double r50p = rp[0] / 1e3;
+   const double r99p = rp[1] / 1e3;
+   const double r99p9 = rp[2] / 1e3;
+   const double wavg = writeHist.getAverage() / 1e3;
+   const double w50p = wp[0] / 1e3;
+   const double w99p = wp[1] / 1e3;
+   const double w99p9 = wp[2] / 1e3;
    dump << "filesize,fill,usedFileSize,io_size,filename,bs,rw,threads,iodepth,reads,writes,rmb,wmb,ravg,wavg,r50p,r99p,r99p9,w50p,w99p,w99p9" << std::endl;
    dump << jobOptions.filesize << "," << jobOptions.fill << "," << jobOptions.filesize << "," << jobOptions.io_size << ",";
    dump << "\"" << jobOptions.filename << "\"," << jobOptions.bs << "," << jobOptions.writePercent << "," << jobOptions.threads << "," << jobOptions.iodepth << ",";
    dump << reads / totalTime << "," << writes / totalTime << "," << reads / totalTime * jobOptions.bs / MEBI << "," << writes / totalTime * jobOptions.bs / MEBI << ",";
-   dump << std::setprecision(6) << (float)reads / rTotalTime * 1e6 << "," << (float)writes / wTotalTime * 1e6 << "," << r50p << "," << r99p << "," << r99p9 << "," << w50p << "," << w99p << "," << w99p9 << "," << std::endl;
+   dump << std::setprecision(6) << (float)reads / rTotalTime * 1e9 << "," << (float)writes / wTotalTime * 1e9 << "," << r50p << "," << r99p << "," << r99p9 << "," << w50p << "," << w99p << "," << w99p9 << "," << std::endl;
    dump.close();
 
    std::cout << "summary ";
@@ -529,8 +610,19 @@ int main(int argc, char** argv) {
       std::cout << " max read: " << maxRead / 1e6 << "M";
    };
    std::cout << std::endl;
-   std::cout << "latency [us]: read avg: " << ravg << " 50p: " << r50p << " 99p: " << r99p << " 99.9p: " << r99p9;
-   std::cout << " write avg: " << wavg << " 50p: " << w50p << " 99p: " << w99p << " 99.9p: " << w99p9 << std::endl;
+   std::cout << "latency [us]: read avg: " << ravg << " 50p: " << r50p << " 99p: " << r99p << " 99.9p: " << r99p9 << " max: " << readHist.maxValue() / 1e3;
+   std::cout << " write avg: " << wavg << " 50p: " << w50p << " 99p: " << w99p << " 99.9p: " << w99p9 << " max: " << writeHist.maxValue() / 1e3 << std::endl;
+   if (jobOptions.openLoop && jobOptions.rateLimit > 0) {
+      // response = service + time the arrival waited for a free request (coordinated omission)
+      readResponseHist.getPercentiles(percentiles, rp, 3);
+      writeResponseHist.getPercentiles(percentiles, wp, 3);
+      std::cout << "response [us]: read avg: " << readResponseHist.getAverage() / 1e3 << " 50p: " << rp[0] / 1e3 << " 99p: " << rp[1] / 1e3 << " 99.9p: " << rp[2] / 1e3 << " max: " << readResponseHist.maxValue() / 1e3;
+      std::cout << " write avg: " << writeResponseHist.getAverage() / 1e3 << " 50p: " << wp[0] / 1e3 << " 99p: " << wp[1] / 1e3 << " 99.9p: " << wp[2] / 1e3 << " max: " << writeResponseHist.maxValue() / 1e3;
+      std::cout << " missed schedule: " << missedSchedule << " (" << 100.0 * missedSchedule / std::max<u64>(reads + writes, 1) << "%)" << std::endl;
+   }
+   // cpu cost of the generator threads per io, excludes kernel threads (sqpoll, io workers)
+   std::cout << "cpu: " << cpuTime / totalTime / jobOptions.threads * 100 << "% per thread " << cpuTime / std::max<u64>(reads + writes, 1) * 1e9 << " ns/io";
+   std::cout << " " << (reads + writes) / std::max(cpuTime, 1e-9) / MEGA << " MIOPS per core" << std::endl;
 
    std::this_thread::sleep_for(std::chrono::seconds(1));
    std::cout << "fin" << std::endl;
@@ -0,0 +1,27 @@
+#!/bin/bash
+set -x
+
+# cpu cost per io of the io_uring engine with and without registered buffers and files (IOUFIXED)
+# reads only, the ssd has to be initialized (INIT=yes once)
+export FILENAME=$1
+export PREFIX=$2
+BS=${3:-4K}
+
+export IOENGINE=io_uring
+export FILL=1
+
+cmake -DCMAKE_BUILD_TYPE=Release ..
+make -j iob
+
+run_cpu_exp() {
+	FIXED=$1
+	IODEPTH=$2
+	sudo -E FILENAME=$FILENAME INIT=disable IO_DEPTH=$IODEPTH BS=$BS THREADS=1 PATTERN=uniform RW=0 RUNTIME=30 IOUFIXED=$FIXED iob/iob >> iob-output-$PREFIX.csv
+	sudo -E FILENAME=$FILENAME INIT=disable IO_DEPTH=$IODEPTH BS=$BS THREADS=1 PATTERN=uniform RW=0 RUNTIME=30 IOUFIXED=$FIXED IOUPOLL=1 iob/iob >> iob-output-$PREFIX.csv
+}
+
+for IODEPTH in 1 32 128; do
+	run_cpu_exp 0 $IODEPTH
+	run_cpu_exp 1 $IODEPTH
+done
+grep -E "^(ionengine|summary|cpu)" iob-output-$PREFIX.csv
@@ -0,0 +1,32 @@
+#!/bin/bash
+set -x
+
+# iops a single core drives with the io_uring setup flags, 4K random reads, one generator thread
+# the ssd has to be initialized (INIT=yes once)
+export FILENAME=$1
+export PREFIX=$2
+BS=${3:-4K}
+
+export IOENGINE=io_uring
+export FILL=1
+
+cmake -DCMAKE_BUILD_TYPE=Release ..
+make -j iob
+
+run_core_exp() {
+	sudo -E FILENAME=$FILENAME INIT=disable IO_DEPTH=128 BS=$BS THREADS=1 PATTERN=uniform RW=0 RUNTIME=30 "$@" iob/iob >> iob-output-$PREFIX.csv
+	sleep 5s
+}
+
+for POLL in 0 1; do
+	run_core_exp IOUPOLL=$POLL
+	run_core_exp IOUPOLL=$POLL IOUREGRING=1
+	run_core_exp IOUPOLL=$POLL IOUSINGLE=1
+	run_core_exp IOUPOLL=$POLL IOUSINGLE=1 IOUREGRING=1
+	run_core_exp IOUPOLL=$POLL IOUCOOP=1
+	run_core_exp IOUPOLL=$POLL IOUDEFER=1
+	run_core_exp IOUPOLL=$POLL IOUDEFER=1 IOUREGRING=1
+	run_core_exp IOUPOLL=$POLL IOUDEFER=1 IOUREGRING=1 IOUFIXED=1
+	run_core_exp IOUPOLL=$POLL IOUDEFER=1 IOUREGRING=1 IOUFIXED=1 IOUWAIT=16
+done
+grep -E "^(ionengine|summary|cpu)" iob-output-$PREFIX.csv
@@ -3,18 +3,22 @@ set -x
 
 export FILENAME=$1
 
-export FILESIZE= # let iob figure it out
+export FILESIZE=${FILESIZE:-} # let iob figure it out (the ssdsim engine needs it)
 export PREFIX=$2
 UNI_BS=${3:-4K}
 SEQ_BS=${4:-512K}
 
-export IOENGINE=io_uring 
+export IOENGINE=${IOENGINE:-io_uring} # ssdsim: runs the scripts against the gc simulator, keep SIMSTATE between runs
 export FILL=1
 
 cmake -DCMAKE_BUILD_TYPE=Release ..
 make -j iob
 
 sanitize_nvme() {
+    if [ "$IOENGINE" = "ssdsim" ]; then
+        rm -f "$SIMSTATE" # a fresh drive
+        return
+    fi
     echo "sanitize"
     sudo nvme sanitize --sanact=2 "$FILENAME"
     sleep 2m
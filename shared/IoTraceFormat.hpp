@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Binary per-I/O trace of iob (--iotrace), written while running by the trace writer thread, read by traces/iobtrace.
+//
+// file:   FileHeader, then chunks
+// chunk:  ChunkHeader, then `records` varint encoded records of one generator thread in completion order
+// record: type byte, zigzag(end - previous end), end - begin, zigzag(addr - previous addr), len, request id
+// The deltas restart in every chunk (from baseEnd and addr 0), a truncated file is readable up to the last whole chunk.
+// Timestamps are tsc, tscPerNs converts them. Little endian, like the machines with a tsc that iob runs on.
+namespace iobtrace {
+
+struct Record {
+   uint64_t begin; // tsc, pushed to the channel
+   uint64_t end;   // tsc, completion seen by the generator
+   uint64_t addr;
+   uint32_t len;
+   uint16_t reqId;
+   uint8_t type; // mean::IoRequestType
+};
+static_assert(sizeof(Record) == 32);
+
+struct FileHeader {
+   char magic[8] = {'I', 'O', 'B', 'T', 'R', 'A', 'C', 'E'};
+   uint32_t version = 1;
+   uint32_t bs = 0;
+   double tscPerNs = 0;
+   uint64_t startTsc = 0; // written as time 0 by the converter
+};
+
+struct ChunkHeader {
+   static constexpr uint32_t chunkMagic = 0x4b4e4843; // "CHNK"
+   uint32_t magic = chunkMagic;
+   uint32_t thread = 0;
+   uint32_t records = 0;
+   uint32_t bytes = 0;   // encoded records after the header
+   uint64_t dropped = 0; // records of this thread lost before this chunk, the ring was full
+   uint64_t baseEnd = 0;
+};
+
+inline uint64_t zigzag(int64_t v) {
+   return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+inline int64_t unzigzag(uint64_t v) {
+   return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+inline void putVarint(std::string& out, uint64_t v) {
+   while (v >= 0x80) {
+      out.push_back((char)(v | 0x80));
+      v >>= 7;
+   }
+   out.push_back((char)v);
+}
+inline uint64_t getVarint(const uint8_t*& p, const uint8_t* end) {
+   uint64_t v = 0;
+   for (unsigned shift = 0; p < end && shift < 64; shift += 7) {
+      const uint8_t b = *p++;
+      v |= (uint64_t)(b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+         break;
+      }
+   }
+   return v;
+}
+
+// one chunk at a time: begin, add the records, then header + data go to the file
+class ChunkEncoder {
+   uint64_t prevEnd = 0;
+   uint64_t prevAddr = 0;
+
+ public:
+   ChunkHeader header;
+   std::string data;
+
+   void begin(uint32_t thread, uint64_t dropped, uint64_t baseEnd) {
+      header = ChunkHeader();
+      header.thread = thread;
+      header.dropped = dropped;
+      header.baseEnd = baseEnd;
+      data.clear();
+      prevEnd = baseEnd;
+      prevAddr = 0;
+   }
+   void add(const Record& r) {
+      data.push_back((char)r.type);
+      putVarint(data, zigzag(r.end - prevEnd));
+      putVarint(data, r.end - r.begin);
+      putVarint(data, zigzag(r.addr - prevAddr));
+      putVarint(data, r.len);
+      putVarint(data, r.reqId);
+      prevEnd = r.end;
+      prevAddr = r.addr;
+      header.records++;
+   }
+   void finish() { header.bytes = data.size(); }
+};
+
+class Reader {
+   std::istream& in;
+   std::string buffer;
+
+ public:
+   FileHeader file;
+
+   explicit Reader(std::istream& in) : in(in) {}
+
+   // false: not an iob trace
+   bool open() {
+      FileHeader expected;
+      return in.read((char*)&file, sizeof(file)) && std::memcmp(file.magic, expected.magic, sizeof(file.magic)) == 0 && file.version == expected.version;
+   }
+   // false: end of the file (or a truncated / corrupt chunk)
+   bool next(ChunkHeader& header, std::vector<Record>& records) {
+      if (!in.read((char*)&header, sizeof(header)) || header.magic != ChunkHeader::chunkMagic) {
+         return false;
+      }
+      buffer.resize(header.bytes);
+      if (!in.read(buffer.data(), header.bytes)) {
+         return false;
+      }
+      records.resize(header.records);
+      const uint8_t* p = (const uint8_t*)buffer.data();
+      const uint8_t* end = p + buffer.size();
+      uint64_t prevEnd = header.baseEnd;
+      uint64_t prevAddr = 0;
+      for (auto& r: records) {
+         if (p >= end) {
+            return false;
+         }
+         r.type = *p++;
+         r.end = prevEnd + unzigzag(getVarint(p, end));
+         r.begin = r.end - getVarint(p, end);
+         r.addr = prevAddr + unzigzag(getVarint(p, end));
+         r.len = getVarint(p, end);
+         r.reqId = getVarint(p, end);
+         prevEnd = r.end;
+         prevAddr = r.addr;
+      }
+      return true;
+   }
+};
+
+} // namespace iobtrace
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Log-linear (hdr style) histogram: values below 2^subBits get their own bucket, above that every power of two is
+// split into 2^subBits buckets, i.e. a fixed relative error of at most 2^-subBits (0.8%) from 1 ns up to 2^maxBits
+// (~18 minutes in ns). Larger values land in the last bucket, min/max stay exact.
+//
+// Recording is single writer (the owning thread) and lock-free: relaxed load + store, no locked instructions.
+// Other threads can read it at any time (per-second stats, summary) and merge several into one with +=.
+// Bucket counts are also summed per group of 64 buckets, a percentile walks the groups and then at most 64 buckets.
+class LogHist {
+ public:
+   static constexpr unsigned subBits = 7;
+   static constexpr unsigned maxBits = 40;
+   static constexpr unsigned subBuckets = 1u << subBits;
+   static constexpr unsigned bucketCount = (maxBits - subBits + 1) * subBuckets;
+   static constexpr unsigned groupSize = 64;
+   static constexpr unsigned groupCount = bucketCount / groupSize;
+   static_assert(bucketCount % groupSize == 0);
+
+ private:
+   std::vector<std::atomic<uint64_t>> counts;
+   std::vector<std::atomic<uint64_t>> groups;
+   std::atomic<uint64_t> cnt = 0;
+   std::atomic<uint64_t> total = 0;
+   std::atomic<uint64_t> min = std::numeric_limits<uint64_t>::max();
+   std::atomic<uint64_t> max = 0;
+
+   static void add(std::atomic<uint64_t>& a, uint64_t v) {
+      a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+   }
+   static uint64_t get(const std::atomic<uint64_t>& a) {
+      return a.load(std::memory_order_relaxed);
+   }
+
+ public:
+   LogHist() : counts(bucketCount), groups(groupCount) {}
+   LogHist(const LogHist&) = delete;
+   LogHist& operator=(const LogHist&) = delete;
+
+   static unsigned index(uint64_t value) {
+      if (value < subBuckets) {
+         return value;
+      }
+      const unsigned msb = std::bit_width(value) - 1;
+      if (msb >= maxBits) {
+         return bucketCount - 1;
+      }
+      const unsigned shift = msb - subBits;
+      return (shift + 1) * subBuckets + ((value >> shift) - subBuckets);
+   }
+   static uint64_t lowerBound(unsigned idx) {
+      if (idx < subBuckets) {
+         return idx;
+      }
+      const unsigned shift = idx / subBuckets - 1;
+      return (uint64_t)(idx % subBuckets + subBuckets) << shift;
+   }
+   // middle of the bucket, the value reported for all values in it
+   static uint64_t bucketValue(unsigned idx) {
+      if (idx < subBuckets) {
+         return idx;
+      }
+      const unsigned shift = idx / subBuckets - 1;
+      return lowerBound(idx) + ((1ull << shift) >> 1);
+   }
+
+   void increaseSlot(uint64_t value) {
+      const unsigned idx = index(value);
+      add(counts[idx], 1);
+      add(groups[idx / groupSize], 1);
+      add(cnt, 1);
+      add(total, value);
+      if (value < get(min)) {
+         min.store(value, std::memory_order_relaxed);
+      }
+      if (value > get(max)) {
+         max.store(value, std::memory_order_relaxed);
+      }
+   }
+
+   uint64_t count() const { return get(cnt); }
+   uint64_t sum() const { return get(total); }
+   uint64_t minValue() const { return get(cnt) == 0 ? 0 : get(min); }
+   uint64_t maxValue() const { return get(max); }
+   double getAverage() const {
+      const uint64_t c = get(cnt);
+      return c == 0 ? 0 : get(total) / (double)c;
+   }
+
+   // percentiles in ascending order, one cumulative pass for all of them
+   void getPercentiles(const double* percentiles, uint64_t* out, int n) const {
+      const uint64_t c = get(cnt);
+      uint64_t cumulative = 0;
+      unsigned g = 0;
+      for (int k = 0; k < n; k++) {
+         if (c == 0) {
+            out[k] = 0;
+            continue;
+         }
+         const uint64_t rank = std::max<uint64_t>(1, std::ceil(c * (percentiles[k] / 100.0)));
+         while (g < groupCount && cumulative + get(groups[g]) < rank) {
+            cumulative += get(groups[g]);
+            g++;
+         }
+         if (g == groupCount) {
+            out[k] = maxValue(); // racing writer, counts ahead of the groups
+            continue;
+         }
+         uint64_t inGroup = cumulative;
+         unsigned idx = g * groupSize;
+         const unsigned end = idx + groupSize - 1;
+         while (idx < end && inGroup + get(counts[idx]) < rank) {
+            inGroup += get(counts[idx]);
+            idx++;
+         }
+         out[k] = std::clamp(bucketValue(idx), minValue(), maxValue());
+      }
+   }
+   uint64_t getPercentile(double percentile) const {
+      uint64_t v;
+      getPercentiles(&percentile, &v, 1);
+      return v;
+   }
+
+   // merge another (live) histogram into this one, e.g. all threads for the summary
+   LogHist& operator+=(const LogHist& rhs) {
+      for (unsigned i = 0; i < bucketCount; i++) {
+         add(counts[i], get(rhs.counts[i]));
+      }
+      for (unsigned g = 0; g < groupCount; g++) {
+         add(groups[g], get(rhs.groups[g]));
+      }
+      add(cnt, get(rhs.cnt));
+      add(total, get(rhs.total));
+      if (get(rhs.cnt) > 0) {
+         min.store(std::min(get(min), get(rhs.min)), std::memory_order_relaxed);
+         max.store(std::max(get(max), get(rhs.max)), std::memory_order_relaxed);
+      }
+      return *this;
+   }
+
+   // difference of two merged snapshots (later -= earlier): the values recorded in between.
+   // min/max can't be taken back, they stay those of the later snapshot.
+   LogHist& operator-=(const LogHist& rhs) {
+      for (unsigned i = 0; i < bucketCount; i++) {
+         add(counts[i], -get(rhs.counts[i]));
+      }
+      for (unsigned g = 0; g < groupCount; g++) {
+         add(groups[g], -get(rhs.groups[g]));
+      }
+      add(cnt, -get(rhs.cnt));
+      add(total, -get(rhs.total));
+      return *this;
+   }
+
+   // owner thread only
+   void resetData() {
+      for (auto& c: counts) {
+         c.store(0, std::memory_order_relaxed);
+      }
+      for (auto& g: groups) {
+         g.store(0, std::memory_order_relaxed);
+      }
+      cnt.store(0, std::memory_order_relaxed);
+      total.store(0, std::memory_order_relaxed);
+      min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      max.store(0, std::memory_order_relaxed);
+   }
+
+   // same columns as Hist
+   static constexpr double csvPercentiles[] = {10, 20, 25, 30, 40, 50, 60, 70, 75, 80, 85, 90, 92.5, 95, 97.5, 99, 99.5, 99.9, 99.99, 99.999};
+   static constexpr const char* csvPercentileNames[] = {"10p", "20p", "25p", "30p", "40p", "50p", "60p", "70p", "75p", "80p", "85p", "90p", "92p5", "95p", "97p5", "99p", "99p5", "99p9", "99p99", "99p999"};
+   static constexpr int csvPercentileCount = std::size(csvPercentiles);
+
+   // the csv columns as plain numbers: taken where the histogram lives, formatted elsewhere (stats logger)
+   struct Summary {
+      uint64_t min = 0;
+      uint64_t percentiles[csvPercentileCount] = {};
+      uint64_t max = 0;
+      uint64_t sum = 0;
+      uint64_t count = 0;
+
+      // values are divided by scale, e.g. 1000 to record in ns and write us
+      void writePercentiles(std::string& result, double scale = 1) const {
+         result += std::to_string(min / scale) + ",";
+         for (uint64_t v: percentiles) {
+            result += std::to_string(v / scale) + ",";
+         }
+         result += std::to_string(max / scale) + ",";
+         result += std::to_string((count == 0 ? 0 : sum / (double)count) / scale) + ",";
+         result += std::to_string(sum / scale) + ",";
+         result += std::to_string(count);
+      }
+   };
+   Summary summary() const {
+      Summary s;
+      getPercentiles(csvPercentiles, s.percentiles, csvPercentileCount);
+      s.min = minValue();
+      s.max = maxValue();
+      s.sum = sum();
+      s.count = count();
+      return s;
+   }
+
+   static void writePercentilesHeader(const std::string& prefix, std::string& result) {
+      result += prefix + "min,";
+      for (const char* name: csvPercentileNames) {
+         result += prefix + name + ",";
+      }
+      result += prefix + "max,";
+      result += prefix + "avg,";
+      result += prefix + "tot,";
+      result += prefix + "cnt";
+   }
+
+   void writePercentiles(std::string& result, double scale = 1) const {
+      summary().writePercentiles(result, scale);
+   }
+};
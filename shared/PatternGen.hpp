@@ -5,6 +5,7 @@
 #include "Env.hpp"
 #include "Exceptions.hpp"
 #include "RejectionInversionZipf.hpp"
+#include "Seed.hpp"
 
 #include <algorithm>
 #include <atomic>
@@ -46,8 +47,15 @@ class PatternGen {
       DB,      // mock db io traces
       ZNS,     // write requests as if it is using ZNS
       SeqZones,
+      Mix,     // tenants with own sub-pattern, rate and lba range
       Undefined
    };
+   // placement handle (FDP) assignment per write
+   enum class Placement {
+      None,   // no handle
+      Zones,  // handle = access zone (zones, seqzones, zns active zone, mix tenant)
+      Ranges, // handle = lba range, the logical space is split into N equal ranges (rangesN)
+   };
    struct Options {
       string patternString;
       string zonesString;
@@ -62,10 +70,16 @@ class PatternGen {
       uint64_t znsActiveZones;
       string znsZoneSizeStr;
       uint64_t znsPagesPerZone;
+      string placementString;
+      string mixString;
+      string traceRemap = "none"; // none, dense, extentN
+      uint64_t seed = 0; // 0: random
    };
    Options options;
    const Pattern pattern;
    bool shuffle;
+   // shuffle and sub generators use sub-streams of it
+   const Seed seed;
    // Shuffle
    std::vector<uint64_t> shuffleVector;
 
@@ -99,10 +113,16 @@ class PatternGen {
    // Zipf
    RejectionInversionZipfSampler zipfSampler;
 
+   // Placement handles, 0 handles: placement disabled
+   Placement placement = Placement::None;
+   uint64_t placementHandles = 0;
+
    // Traces
    std::vector<uint64_t> inputTraces;
    size_t traceIndex = 0;
    std::string traceFilePath;
+   ParsedTraceFile parsedTraceFile; // of this generator (mix tenants read their own traces)
+   std::ifstream parsedTrace;
    const size_t chunkSize = 100000; // trace file chunk size to load on the memory
 
    // ZNS
@@ -111,21 +131,26 @@ class PatternGen {
    std::vector<int64_t> znsActiveZoneIds;
    std::vector<int64_t> znsActiveZoneOffset;
 
+   // Discards (trims), collected only if emitDiscards is set, otherwise discards of traces are skipped
+   // the consumer drains the vector before it applies the next write
+   bool emitDiscards = false;
+   std::vector<std::pair<uint64_t, uint64_t>> discards; // first page, count (after shuffle)
+
    // Trace accesses
    bool traceAccessedPages = false;
    std::vector<uint64_t> accessedPages;
 
-   PatternGen(Options options) : options(options), pattern(stringToPattern(options.patternString)), zipfSampler(options.logicalPages, options.skewFactor) {
+   PatternGen(Options options) : options(options), pattern(stringToPattern(options.patternString)), seed(options.seed), zipfSampler(options.logicalPages, options.skewFactor) {
       shuffle = !options.patternString.contains("-noshuffle");                                         // default is shuffle
-      if (pattern == Pattern::Sequential || pattern == Pattern::SeqZones || pattern == Pattern::ZNS || pattern == Pattern::Uniform) { // except for
+      if (pattern == Pattern::Sequential || pattern == Pattern::SeqZones || pattern == Pattern::ZNS || pattern == Pattern::Uniform || pattern == Pattern::Mix) { // except for
          shuffle = options.patternString.contains("-shuffle");
       }
       rndPage = std::uniform_int_distribution<uint64_t>(0, options.logicalPages - 1);
       //std::cout << "PatternGen: shuffle: " << shuffle << " totalWrites: " << options.totalWrites << std::endl;
       init();
    }
-   PatternGen(Pattern pattern, uint64_t logicalPages, double skewFactor = 1.0, bool shuffle = true)
-       : pattern(pattern), shuffle(shuffle), zipfSampler(logicalPages, skewFactor) {
+   PatternGen(Pattern pattern, uint64_t logicalPages, double skewFactor = 1.0, bool shuffle = true, uint64_t seed = 0)
+       : pattern(pattern), shuffle(shuffle), seed(seed), zipfSampler(logicalPages, skewFactor) {
       options.logicalPages = logicalPages;
       options.skewFactor = skewFactor;
       rndPage = std::uniform_int_distribution<uint64_t>(0, options.logicalPages - 1);
@@ -143,6 +168,9 @@ class PatternGen {
       app.add_option("--zns-active-zones", pgOptions->znsActiveZones, "Number of active ZNS zones")->envname("ZNS_ACTIVE_ZONES")->default_val(4);
       app.add_option("--zns-zone-size", pgOptions->znsZoneSizeStr, "ZNS zone size in pages")->envname("ZNS_ZONE_SIZE")->default_val(("1G"));
       app.add_option("--zipf", pgOptions->skewFactor, "Skew factor for zipf pattern")->envname("ZIPF")->default_val(1.0);
+      app.add_option("--placement", pgOptions->placementString, "Placement handle per write: none, zones, rangesN (sim: greedy gc only, gc keeps the data of each handle apart)")->envname("PLACEMENT")->default_val("none");
+      app.add_option("--trace-remap", pgOptions->traceRemap, "Renumbering of the pages of traces: none, dense (touched pages), extentN (extents of N pages, keeps locality)")->envname("TRACE_REMAP")->default_val("none");
+      app.add_option("--mix", pgOptions->mixString, "Tenants of the mix pattern, ';' separated, e.g. \"r3 s0.5 zipf0.9; r1 s0.5 uniform\"")->envname("MIX")->default_val("");
       return pgOptions;
    }
    static void cliOptionsParsed(Options& pgOptions, uint64_t logicalPages, uint64_t pageSize) {
@@ -157,11 +185,16 @@ class PatternGen {
       if (!pgOptions.patternString.contains("zipf")) {
          pgOptions.skewFactor = 0;
       }
+      if (pgOptions.patternString != "mix") {
+         pgOptions.mixString = "";
+      }
    }
 
    static Pattern stringToPattern(std::string pattern) {
       Pattern ret;
-      if (pattern.contains("sequential")) {
+      if (pattern == "mix") {
+         ret = Pattern::Mix;
+      } else if (pattern.contains("sequential")) {
          ret = Pattern::Sequential;
       } else if (pattern.contains("uniform")) {
          ret = Pattern::Uniform;
@@ -196,6 +229,8 @@ class PatternGen {
          patternDetails = "a:" + to_string(options.alpha) + " b:" + to_string(options.beta);
       } else if (pattern == Pattern::Zipf || pattern == Pattern::FioZipf) {
          patternDetails = to_string(options.skewFactor);
+      } else if (pattern == Pattern::Mix) {
+         patternDetails = options.mixString;
       } else if (pattern == Pattern::ZNS) {
          patternDetails = "activeZones: " + to_string(options.znsActiveZones) + " pagesPerZone: " + to_string(options.znsPagesPerZone);
       }
@@ -211,7 +246,13 @@ class PatternGen {
       } else if (this->pattern == Pattern::Traces) {
          // use real-world traces
          traceFilePath = getTraceFilePath(options.patternString);
-         validateAndLoadTraceFiles(traceFilePath, options.patternString, options.sectorSize, options.logicalPages, options.pageSize, inputTraces);
+         parsedTraceFile = validateAndLoadTraceFiles(traceFilePath, options.patternString, options.sectorSize, options.logicalPages, options.pageSize, inputTraces, options.traceRemap);
+         parsedTrace.open(parsedTraceFile.file);
+         TraceFootprint footprint = readTraceFootprint(parsedTraceFile.file);
+         printTraceFootprint(footprint, options.pageSize);
+         ensurem(footprint.addressRange <= options.logicalPages, "trace pages up to " + to_string(footprint.addressRange) + " exceed the " + to_string(options.logicalPages) + " logical pages, use --trace-remap or --fit-trace");
+      } else if (this->pattern == Pattern::Mix) {
+         parseAndInitMixAccessPattern();
       } else if (this->pattern == Pattern::Zones) {
          parseAndInitZoneAccessPattern();
       } else if (this->pattern == Pattern::SeqZones) {
@@ -219,27 +260,83 @@ class PatternGen {
       } else if (this->pattern == Pattern::ZNS) {
          parseAndInitZNSAccessPattern();
       }
+      initPlacement();
       if (shuffle) {
          shuffleVector.resize(options.logicalPages);
          for (uint64_t i = 0; i < shuffleVector.size(); i++) {
             shuffleVector[i] = i;
          }
-         std::random_device rd;
-         std::mt19937_64 g(rd());
+         std::mt19937_64 g = seed.split(0).rng();
          std::shuffle(shuffleVector.begin(), shuffleVector.end(), g);
       }
    }
 
+   void initPlacement() {
+      const string& str = options.placementString;
+      if (str.empty() || str == "none") {
+         return;
+      }
+      if (str == "zones") {
+         ensurem(zoneCount() > 0, "zones placement needs a zones, seqzones, zns or mix pattern");
+         placement = Placement::Zones;
+         placementHandles = zoneCount();
+      } else if (str.starts_with("ranges")) {
+         placement = Placement::Ranges;
+         placementHandles = std::stoul(str.substr(6));
+      } else {
+         ensurem(false, "placement does not exist: " + str);
+      }
+      ensurem(placementHandles > 0 && placementHandles < 255, "placement handles must be in [1, 254]");
+   }
+
+   // number of access zones (tenants of mix), 0 for patterns without zones
+   uint64_t zoneCount() const {
+      return (pattern == Pattern::Zones || pattern == Pattern::SeqZones || pattern == Pattern::ZNS || pattern == Pattern::Mix) ? accessZones.size() : 0;
+   }
+
+   // zone that owns each page (the zone of all its writes), e.g. for the initial fill.
+   // overlapping mix tenants: the first one. 0 for pages outside every zone and for zns, whose zones are write streams
+   std::vector<uint16_t> pageZones() const {
+      std::vector<uint16_t> zones(options.logicalPages, 0);
+      if (zoneCount() == 0 || pattern == Pattern::ZNS) {
+         return zones;
+      }
+      for (uint64_t z = accessZones.size(); z-- > 0;) {
+         const AccessZone& az = accessZones[z];
+         for (uint64_t idx = az.offset; idx < az.offset + az.count; idx++) {
+            zones[shuffle ? shuffleVector.at(idx) : idx] = z;
+         }
+      }
+      return zones;
+   }
+
+   uint8_t placementHandle(uint64_t page, int zone) const {
+      if (placement == Placement::Zones) {
+         return zone;
+      } else if (placement == Placement::Ranges) {
+         return (u128)page * placementHandles / options.logicalPages;
+      }
+      return 0;
+   }
+
    int64_t accessPatternGenerator(std::mt19937_64& gen) {
+      uint8_t handle;
+      return accessPatternGenerator(gen, handle);
+   }
+
+   // handle: placement handle of the access, 0 if placement is disabled
+   // zoneId: access zone of zones, seqzones and zns patterns, tenant of mix, 0 otherwise
+   int64_t accessPatternGenerator(std::mt19937_64& gen, uint8_t& handle, int* zoneId = nullptr) {
       uint64_t page = 0;
+      int zone = 0;
       if (pattern == Pattern::Sequential) {
          page = seq++ % options.logicalPages;
       } else if (pattern == Pattern::Uniform) {
          page = rndPage(gen);
       } else if (pattern == Pattern::SeqZones) {
-         page = accessZonesGenerator(gen);
-      } else if (pattern == Pattern::Zones) {
-         page = accessZonesGenerator(gen);
+         page = accessZonesGenerator(gen, &zone);
+      } else if (pattern == Pattern::Zones || pattern == Pattern::Mix) {
+         page = accessZonesGenerator(gen, &zone);
       } else if (pattern == Pattern::Beta) {
          double beta_val;
          beta_val = beta_distribution(gen, options.alpha, options.beta);
@@ -249,11 +346,15 @@ class PatternGen {
       } else if (pattern == Pattern::FioZipf) {
          page = getPageFromFIOTrace();
       } else if (pattern == Pattern::Traces) {
-         page = getPageFromParsedTrace(inputTraces, traceIndex, chunkSize);
+         page = getPageFromParsedTrace(parsedTrace, inputTraces, traceIndex, chunkSize);
+         while (page & traceDiscardFlag) {
+            addDiscard(page & ~traceDiscardFlag, 1);
+            page = getPageFromParsedTrace(parsedTrace, inputTraces, traceIndex, chunkSize);
+         }
       } else if (pattern == Pattern::DB) {
          page = accessDBGenerator(gen);
       } else if (pattern == Pattern::ZNS) {
-         page = accessZNS(gen);
+         page = accessZNS(gen, &zone);
       } else {
          throw std::runtime_error("Error: pattern not implemented.");
       }
@@ -273,9 +374,29 @@ class PatternGen {
       }
       // std::cout << "page: " << page << std::endl;
       ensure(page >= 0 && page < options.logicalPages);
+      handle = placementHandle(page, zone);
+      if (zoneId) {
+         *zoneId = zone;
+      }
       return page;
    }
 
+   void addDiscard(uint64_t first, uint64_t count) {
+      if (!emitDiscards || first >= options.logicalPages) {
+         return;
+      }
+      count = std::min(count, options.logicalPages - first);
+      if (shuffle) {
+         for (uint64_t p = first; p < first + count; p++) {
+            discards.emplace_back(shuffleVector.at(p), 1);
+         }
+      } else if (!discards.empty() && discards.back().first + discards.back().second == first) {
+         discards.back().second += count;
+      } else {
+         discards.emplace_back(first, count);
+      }
+   }
+
    double sumFreq = 0;
    std::vector<AccessZone> accessZones;
 
@@ -349,8 +470,9 @@ class PatternGen {
          assigned2 += h.count;
          lastEnd += h.count;
       }
+      uint64_t zoneIdx = 0;
       ensurem(pageCount == assigned2, "Pages not correclyt assinged") for (auto& h: accessZones) {
-         h.subGen = std::make_unique<PatternGen>(h.pattern, h.count, h.skewFactor, h.shuffle);
+         h.subGen = std::make_unique<PatternGen>(h.pattern, h.count, h.skewFactor, h.shuffle, seed.split(1 + zoneIdx++).value);
          h.print();
          cout << endl;
       }
@@ -374,7 +496,7 @@ class PatternGen {
       initZoneAccessPattern();
    }
 
-   uint64_t accessZonesGenerator(std::mt19937_64& gen) {
+   uint64_t accessZonesGenerator(std::mt19937_64& gen, int* zoneId = nullptr) {
       std::uniform_real_distribution<double> realDist(0, sumFreq);
       double randFreq = realDist(gen);
       int randZoneId = 0;
@@ -388,11 +510,95 @@ class PatternGen {
       // std::cout << "randZoneId: " << randZoneId << std::endl;
       // std::uniform_int_distribution<long> rndPageInZone(az.offset, az.offset + az.count - 1);
       // uint64_t idx = rndPageInZone(gen);
+      az.subGen->emitDiscards = emitDiscards;
       uint64_t idx = az.offset + az.subGen->accessPatternGenerator(gen);
+      // discards of sub-generators (traces in a mix) move to the zone's range
+      for (auto [first, count]: az.subGen->discards) {
+         addDiscard(az.offset + first, count);
+      }
+      az.subGen->discards.clear();
+      if (zoneId) {
+         *zoneId = randZoneId;
+      }
       // std::cout << "randZoneId: " << randZoneId << " idx: " << idx << " (offset: " << az.offset << ")" << std::endl;
       return idx;
    }
 
+   // Mix: tenants separated by ';', each a list of keywords
+   //   r<weight>    rate weight, share of the accesses (default 1)
+   //   s<size>      size as fraction of the lba space
+   //   o<offset>    start as fraction of the lba space (default: after the previous tenant), tenants may overlap
+   //   uniform, sequential, zipf<skew>, trace_<name> (default uniform), shuffle, noshuffle
+   // e.g. "r3 s0.5 zipf0.9; r1 s0.5 uniform" or "r1 s1 uniform; r4 o0.9 s0.1 sequential"
+   void parseAndInitMixAccessPattern() {
+      ensurem(!options.mixString.empty(), "mix pattern needs --mix");
+      std::stringstream tenants(options.mixString);
+      double nextOffset = 0;
+      uint64_t tenantIdx = 0;
+      for (std::string tenant; std::getline(tenants, tenant, ';');) {
+         if (tenant.find_first_not_of(' ') == string::npos) {
+            continue; // e.g. trailing ';'
+         }
+         double rate = 1;
+         double size = -1;
+         double offset = nextOffset;
+         Pattern pattern = Pattern::Uniform;
+         string traceName;
+         double skewFactor = 0;
+         bool shuffle = false;
+         std::stringstream ss(tenant);
+         std::string value;
+         while (ss >> value) {
+            if (value[0] == 'r') {
+               rate = std::stod(value.substr(1));
+            } else if (value[0] == 's' && value != "shuffle" && value != "sequential") {
+               size = std::stod(value.substr(1));
+            } else if (value[0] == 'o') {
+               offset = std::stod(value.substr(1));
+            } else if (value == "uniform") {
+               pattern = Pattern::Uniform;
+            } else if (value == "sequential") {
+               pattern = Pattern::Sequential;
+            } else if (value.starts_with("zipf")) {
+               pattern = Pattern::Zipf;
+               skewFactor = std::stod(value.substr(4));
+            } else if (value.starts_with("trace_")) {
+               pattern = Pattern::Traces;
+               traceName = value;
+            } else if (value == "shuffle") {
+               shuffle = true;
+            } else if (value == "noshuffle") {
+               shuffle = false;
+            } else {
+               ensurem(false, "Mix keyword not recognized: " + value);
+            }
+         }
+         ensurem(size > 0 && rate > 0 && offset >= 0 && offset + size <= 1 + 1e-9, "mix tenant needs s in (0, 1], r > 0 and o + s <= 1: " + tenant);
+         AccessZone& t = accessZones.emplace_back(size, rate, pattern, skewFactor, shuffle);
+         t.offset = offset * options.logicalPages;
+         t.count = std::min<uint64_t>(std::max<uint64_t>(1, size * options.logicalPages), options.logicalPages - t.offset);
+         uint64_t tenantSeed = seed.split(1 + tenantIdx++).value;
+         if (pattern == Pattern::Traces) {
+            // trace pages are mapped into the tenant's range
+            Options traceOptions = options;
+            traceOptions.patternString = traceName;
+            traceOptions.logicalPages = t.count;
+            traceOptions.placementString = "none";
+            traceOptions.mixString = "";
+            traceOptions.seed = tenantSeed;
+            t.subGen = std::make_unique<PatternGen>(traceOptions);
+         } else {
+            t.subGen = std::make_unique<PatternGen>(pattern, t.count, skewFactor, shuffle, tenantSeed);
+         }
+         sumFreq += rate;
+         nextOffset = offset + size;
+         cout << "tenant " << accessZones.size() - 1 << ": " << (traceName.empty() ? "" : traceName + " ");
+         t.print();
+         cout << endl;
+      }
+      ensurem(!accessZones.empty(), "mix without tenants");
+   }
+
    uint64_t accessDBGenerator(std::mt19937_64& gen) {
       std::uniform_real_distribution<double> realDist(0, sumFreq);
       double randFreq = realDist(gen);
@@ -432,7 +638,7 @@ class PatternGen {
       std::fill(znsActiveZoneOffset.begin(), znsActiveZoneOffset.end(), options.znsPagesPerZone);
    }
 
-   uint64_t accessZNS(std::mt19937_64& gen) {
+   uint64_t accessZNS(std::mt19937_64& gen, int* zoneId = nullptr) {
       std::uniform_real_distribution<double> realDist(0, sumFreq);
       double randFreq = realDist(gen);
       int randZoneId = 0;
@@ -442,6 +648,9 @@ class PatternGen {
          freqCnt += accessZones.at(randZoneId).freq;
       }
       assert(randZoneId >= 0 && randZoneId < accessZones.size());
+      if (zoneId) {
+         *zoneId = randZoneId;
+      }
       // have to mutex the following
       std::lock_guard<std::mutex> guard(znsMutex);
       uint64_t idInZone = znsActiveZoneOffset[randZoneId]++;
@@ -455,6 +664,8 @@ class PatternGen {
          } while (std::find(znsActiveZoneIds.begin(), znsActiveZoneIds.end(), randomZone) != znsActiveZoneIds.end());
          znsActiveZoneIds[randZoneId] = randomZone;
          znsActiveZoneOffset[randZoneId] = 0;
+         // zone reset before it is rewritten
+         addDiscard(randomZone * options.znsPagesPerZone, options.znsPagesPerZone);
          idx = znsActiveZoneIds[randZoneId] * options.znsPagesPerZone + znsActiveZoneOffset[randZoneId]++;
       } else {
          idx = znsActiveZoneIds[randZoneId] * options.znsPagesPerZone + idInZone;
@@ -559,14 +770,29 @@ class PatternGen {
       cout << "Pattern: " << options.patternString << " Skew factor: " << options.skewFactor << endl;
    }
 
+   // logical pages a trace pattern needs: its address range after remapping, parses the trace if necessary
+   static uint64_t traceAddressRange(const Options& options) {
+      std::vector<uint64_t> unused;
+      ParsedTraceFile parsed = validateAndLoadTraceFiles(getTraceFilePath(options.patternString), options.patternString, options.sectorSize, options.logicalPages, options.pageSize, unused, options.traceRemap);
+      return readTraceFootprint(parsed.file).addressRange;
+   }
+
+   // the pattern replays trace files (also mix tenants)
+   static bool readsTraces(const Options& options) {
+      Pattern pattern = stringToPattern(options.patternString);
+      return pattern == Pattern::Traces || (pattern == Pattern::Mix && options.mixString.contains("trace"));
+   }
+
    static void printPatternHistorgram(Options options) {
+      if (readsTraces(options)) {
+         return; // trace pages do not fit the 100 pages of the histogram
+      }
       cout << "Distribution Histogram" << endl;
       options.logicalPages = 100;
       options.znsPagesPerZone = 10;
       options.znsActiveZones = 4;
       long totalWrites = 10e6;
-      std::random_device rd;
-      std::mt19937_64 rng{rd()};
+      std::mt19937_64 rng = Seed(options.seed).rng();
       PatternGen pg(options);
       std::vector<int> vec(options.logicalPages);
       for (uint64_t i = 0; i < totalWrites; i++) {
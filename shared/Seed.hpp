@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+// Splittable seeds for reproducible runs: every component derives its own independent
+// sub-stream from the run seed, so adding a random draw in one component does not shift the others.
+// Seed 0 means non-deterministic, a random seed is drawn (and can be printed to reproduce the run).
+class Seed {
+ public:
+   const uint64_t value;
+
+   explicit Seed(uint64_t value = 0) : value(value ? value : random()) {}
+
+   static uint64_t splitmix64(uint64_t x) {
+      x += 0x9e3779b97f4a7c15ULL;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      return x ^ (x >> 31);
+   }
+
+   // seed of sub-stream id, the same id always gives the same seed
+   Seed split(uint64_t id) const {
+      return Seed(splitmix64(value ^ splitmix64(id + 1)) | 1);
+   }
+
+   std::mt19937_64 rng() const {
+      std::seed_seq seq{(uint32_t)value, (uint32_t)(value >> 32)};
+      return std::mt19937_64(seq);
+   }
+
+ private:
+   static uint64_t random() {
+      std::random_device rd;
+      return ((uint64_t)rd() << 32 | rd()) | 1;
+   }
+};
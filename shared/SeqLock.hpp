@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single writer, many readers: the latest value of a small trivially copyable struct.
+// Readers never block the writer, they retry if a store was in progress. The value is kept in
+// relaxed atomic words (no data race), the sequence number orders them.
+template <typename T>
+class SeqLock {
+   static_assert(std::is_trivially_copyable_v<T>);
+   static constexpr size_t words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+   std::atomic<uint64_t> seq = 0; // odd: store in progress
+   std::array<std::atomic<uint64_t>, words> data{};
+
+ public:
+   SeqLock() = default;
+   explicit SeqLock(const T& value) { store(value); }
+
+   void store(const T& value) {
+      uint64_t buf[words] = {};
+      std::memcpy(buf, &value, sizeof(T));
+      const uint64_t s = seq.load(std::memory_order_relaxed);
+      seq.store(s + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (size_t i = 0; i < words; i++) {
+         data[i].store(buf[i], std::memory_order_relaxed);
+      }
+      seq.store(s + 2, std::memory_order_release);
+   }
+
+   T load() const {
+      uint64_t buf[words];
+      uint64_t s1;
+      uint64_t s2;
+      do {
+         s1 = seq.load(std::memory_order_acquire);
+         for (size_t i = 0; i < words; i++) {
+            buf[i] = data[i].load(std::memory_order_relaxed);
+         }
+         std::atomic_thread_fence(std::memory_order_acquire);
+         s2 = seq.load(std::memory_order_relaxed);
+      } while (s1 != s2 || (s1 & 1));
+      T value;
+      std::memcpy(&value, buf, sizeof(T));
+      return value;
+   }
+
+   // number of stores so far
+   uint64_t version() const { return seq.load(std::memory_order_acquire) / 2; }
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Single producer, single consumer ring of fixed-size records, capacity rounded up to a power of two.
+// The producer never blocks: push fails (and counts an overrun) when the consumer is a full ring behind.
+// Both sides keep a cached copy of the other index and only touch its cache line when that copy runs out.
+template <typename T>
+class SpscRing {
+   static_assert(std::is_trivially_copyable_v<T>);
+   std::vector<T> slots;
+   const uint64_t mask;
+
+   alignas(64) std::atomic<uint64_t> head = 0; // next push, written by the producer
+   uint64_t cachedTail = 0;
+   std::atomic<uint64_t> overruns = 0;
+   alignas(64) std::atomic<uint64_t> tail = 0; // next pop, written by the consumer
+   uint64_t cachedHead = 0;
+
+ public:
+   explicit SpscRing(uint64_t capacity) : slots(std::bit_ceil(std::max<uint64_t>(capacity, 2))), mask(slots.size() - 1) {}
+   SpscRing(const SpscRing&) = delete;
+   SpscRing& operator=(const SpscRing&) = delete;
+
+   uint64_t capacity() const { return slots.size(); }
+
+   // producer
+   bool push(const T& value) {
+      const uint64_t h = head.load(std::memory_order_relaxed);
+      if (h - cachedTail == slots.size()) {
+         cachedTail = tail.load(std::memory_order_acquire);
+         if (h - cachedTail == slots.size()) {
+            overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+         }
+      }
+      slots[h & mask] = value;
+      head.store(h + 1, std::memory_order_release);
+      return true;
+   }
+
+   // consumer
+   bool pop(T& value) {
+      const uint64_t t = tail.load(std::memory_order_relaxed);
+      if (t == cachedHead) {
+         cachedHead = head.load(std::memory_order_acquire);
+         if (t == cachedHead) {
+            return false;
+         }
+      }
+      value = slots[t & mask];
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+   }
+
+   // records lost because the ring was full
+   uint64_t overrunCount() const { return overruns.load(std::memory_order_relaxed); }
+};
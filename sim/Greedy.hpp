@@ -5,31 +5,68 @@
 
 #include "Exceptions.hpp"
 #include "SSD.hpp"
+#include "Seed.hpp"
 
 #include <algorithm>
 #include <csignal>
 #include <fstream>
 #include <list>
 #include <random>
+#include <vector>
+
+// wear leveling policies of the greedy gc
+// dynamic: new writes go to the least worn free block, victim ties are broken by the lower erase count
+// static: once the erase count spread exceeds the threshold, the data of the least worn (cold) block
+//         is moved to the most worn free block and the cold block is put back into circulation.
+//         the spread is checked at most every interval erases, a check scans all blocks
+struct WearLeveling {
+   bool dynamic = false;
+   bool staticWL = false;
+   uint64_t threshold = 0;
+   uint64_t interval = 1;
+
+   static WearLeveling parse(const std::string& policy, uint64_t threshold, uint64_t interval = 1) {
+      WearLeveling wl;
+      wl.threshold = threshold;
+      wl.interval = std::max<uint64_t>(1, interval);
+      if (policy == "dynamic" || policy == "both") {
+         wl.dynamic = true;
+      }
+      if (policy == "static" || policy == "both") {
+         wl.staticWL = true;
+      }
+      ensurem(wl.dynamic || wl.staticWL || policy == "none", "wear leveling policy does not exist: " + policy);
+      return wl;
+   }
+   bool enabled() const { return dynamic || staticWL; }
+};
 
 class GreedyGC {
    SSD& ssd;
-   uint64_t currentBlock;
+   // one open block (reclaim unit) per placement handle
+   std::vector<uint64_t> currentBlocks;
    int64_t currentGCBlock = -1;
+   // with placement handles: one open gc destination block per handle, victims are moved page by page
+   // to the block of the handle that last wrote the page and erased, so gc data is not mixed across handles
+   std::vector<int64_t> gcBlocks;
    // k - greedy
    int k;
    bool simpleTwoR;
-   std::random_device rd;
-   std::mt19937_64 gen{rd()};
+   std::mt19937_64 gen;
    std::uniform_int_distribution<uint64_t> rndBlockDist;
    std::list<uint64_t> freeBlocks;
+   WearLeveling wl;
+   uint64_t wlMigrations = 0;
+   uint64_t nextWLCheck = 0; // erase count of the ssd
 
  public:
-   GreedyGC(SSD& ssd, int k = 0, bool twoR = false) : ssd(ssd), k(k), simpleTwoR(twoR), rndBlockDist(0, ssd.blockCount - 1) {
+   // seed 0: random
+   GreedyGC(SSD& ssd, int k = 0, bool twoR = false, WearLeveling wl = {}, uint64_t seed = 0)
+       : ssd(ssd), k(k), simpleTwoR(twoR), gen(Seed(seed).rng()), rndBlockDist(0, ssd.blockCount - 1), wl(wl) {
       for (uint64_t z = 0; z < ssd.blockCount; z++) {
          freeBlocks.push_back(z);
       }
-      currentBlock = freeBlocks.front();
+      currentBlocks.push_back(freeBlocks.front());
       freeBlocks.pop_front();
    }
    string name() const {
@@ -41,14 +78,33 @@ class GreedyGC {
       }
       return "greedy-k" + std::to_string(k);
    }
-   void writePage(uint64_t pageId) {
+   // with placement handles, one gc of a victim can fill up to one gc block per handle
+   bool placement() const { return ssd.handleAttribution().classes() > 1; }
+   uint64_t gcReserve() const { return placement() ? ssd.handleAttribution().classes() : 0; }
+   uint64_t nextFreeBlock() {
+      while (freeBlocks.size() <= gcReserve()) {
+         performGC();
+      }
+      return takeFreeBlock();
+   }
+   uint64_t takeFreeBlock() {
+      ensure(!freeBlocks.empty());
+      auto it = freeBlocks.begin();
+      if (wl.dynamic) {
+         it = std::ranges::min_element(freeBlocks, {}, [&](uint64_t b) { return ssd.blocks()[b].eraseCount(); });
+      }
+      uint64_t block = *it;
+      freeBlocks.erase(it);
+      ensure(ssd.blocks()[block].canWrite());
+      return block;
+   }
+   void writePage(uint64_t pageId, uint8_t handle = 0) {
+      while (handle >= currentBlocks.size()) { // first write of a handle
+         currentBlocks.push_back(nextFreeBlock());
+      }
+      uint64_t& currentBlock = currentBlocks[handle];
       if (!ssd.blocks()[currentBlock].canWrite()) {
-         if (freeBlocks.empty()) {
-            performGC();
-         }
-         currentBlock = freeBlocks.front();
-         freeBlocks.pop_front();
-         ensure(ssd.blocks()[currentBlock].canWrite());
+         currentBlock = nextFreeBlock();
       }
       ssd.writePage(pageId, currentBlock);
    }
@@ -60,6 +116,8 @@ class GreedyGC {
          if (block.validCnt() < minCnt && block.fullyWritten()) { // only use full blocks for gc
             minIdx = i;
             minCnt = block.validCnt();
+         } else if (wl.dynamic && block.validCnt() == minCnt && block.fullyWritten() && block.eraseCount() < ssd.blocks()[minIdx].eraseCount()) {
+            minIdx = i;
          }
       }
       ensure(minIdx != -1);
@@ -107,8 +165,21 @@ class GreedyGC {
             victimBlockIdx = minIdx;
          }
          ensure(victimBlockIdx != -1);
-         ssd.compactBlock(victimBlockIdx);
+         if (placement()) {
+            if (!ssd.blocks()[victimBlockIdx].fullyWritten()) {
+               victimBlockIdx = singleGreedy(); // k-greedy may draw an open (host or gc) block
+            }
+            relocateByHandle(victimBlockIdx);
+         } else {
+            ssd.compactBlock(victimBlockIdx);
+         }
          freeBlocks.push_back(victimBlockIdx);
+         if (wl.staticWL && ssd.erases() >= nextWLCheck) {
+            nextWLCheck = ssd.erases() + wl.interval;
+            if (ssd.eraseSpread() > wl.threshold) {
+               staticWearLeveling();
+            }
+         }
       } else {
          // compact until free block using singleGreedy
          auto [freeBlock, gcBlock] = ssd.compactUntilFreeBlock(currentGCBlock, [&]() { return singleGreedy(); });
@@ -117,8 +188,94 @@ class GreedyGC {
          freeBlocks.push_back(freeBlock);
       }
    }
+   // moves the valid pages of the victim to the gc block of their handle and erases the victim
+   void relocateByHandle(uint64_t victim) {
+      gcBlocks.resize(ssd.handleAttribution().classes(), -1);
+      ssd.relocateBlock(victim, [&](PID logPage) -> BID {
+         int64_t& gcBlock = gcBlocks[ssd.handleAttribution().classOf(logPage)];
+         if (gcBlock == -1 || !ssd.blocks()[gcBlock].canWrite()) {
+            gcBlock = takeFreeBlock();
+         }
+         return gcBlock;
+      });
+   }
+   // moves the data of the least worn full block to the most worn free block (it still holds compacted data
+   // at the front), the rest of the cold block is compacted in place. The cold block becomes a free block.
+   void staticWearLeveling() {
+      auto open = [&](uint64_t b) { return std::ranges::find(currentBlocks, b) != currentBlocks.end() || std::ranges::find(gcBlocks, (int64_t)b) != gcBlocks.end(); };
+      int64_t coldIdx = -1;
+      for (uint64_t i = 0; i < ssd.blockCount; i++) {
+         const SSD::Block& block = ssd.blocks()[i];
+         if (block.fullyWritten() && (coldIdx == -1 || block.eraseCount() < ssd.blocks()[coldIdx].eraseCount()) && !open(i)) {
+            coldIdx = i;
+         }
+      }
+      if (coldIdx == -1 || ssd.blocks()[coldIdx].eraseCount() + wl.threshold >= ssd.eraseMax()) {
+         return;
+      }
+      // relocations are wear leveling writes, not gc writes of the handles/zones
+      ssd.wearLevelingWrites([&]() {
+         if (placement()) {
+            relocateByHandle(coldIdx); // the cold data goes to the gc blocks of its handles
+            return;
+         }
+         auto worn = std::ranges::max_element(freeBlocks, {}, [&](uint64_t b) { return ssd.blocks()[b].eraseCount(); });
+         if (worn != freeBlocks.end() && *worn != (uint64_t)coldIdx) {
+            uint64_t wornIdx = *worn;
+            ssd.moveValidPagesTo(coldIdx, wornIdx);
+            if (!ssd.blocks()[wornIdx].canWrite()) {
+               freeBlocks.erase(worn);
+            }
+         }
+         if (ssd.blocks()[coldIdx].allInvalid()) {
+            ssd.eraseBlock(coldIdx);
+         } else {
+            ssd.compactBlock(coldIdx);
+         }
+      });
+      if (ssd.blocks()[coldIdx].canWrite()) {
+         freeBlocks.push_back(coldIdx);
+      }
+      wlMigrations++;
+   }
    void stats() {
-      std::cout << "Greedy stats" << std::endl;
+      std::cout << "Greedy stats";
+      if (wl.enabled()) {
+         std::cout << " wl migrations: " << wlMigrations << " erase count min: " << ssd.eraseMin() << " max: " << ssd.eraseMax();
+      }
+      std::cout << std::endl;
+      wlMigrations = 0;
    }
    void resetStats() {}
+   uint64_t freeBlockCount() const { return freeBlocks.size(); }
+   // open and free blocks, saved with SSD::save
+   void save(std::ostream& out) const {
+      auto put = [&](uint64_t v) { out.write(reinterpret_cast<const char*>(&v), sizeof(v)); };
+      put(currentBlocks.size());
+      for (uint64_t b: currentBlocks) {
+         put(b);
+      }
+      put(currentGCBlock);
+      put(freeBlocks.size());
+      for (uint64_t b: freeBlocks) {
+         put(b);
+      }
+   }
+   void load(std::istream& in) {
+      auto get = [&]() {
+         uint64_t v = 0;
+         in.read(reinterpret_cast<char*>(&v), sizeof(v));
+         return v;
+      };
+      currentBlocks.resize(get());
+      for (uint64_t& b: currentBlocks) {
+         b = get();
+      }
+      currentGCBlock = get();
+      freeBlocks.clear();
+      for (uint64_t n = get(); n > 0; n--) {
+         freeBlocks.push_back(get());
+      }
+      ensurem(in.good(), "truncated gc snapshot");
+   }
 };
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../shared/Exceptions.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Exact page lifetimes: host writes between a write of a logical page and its overwrite.
+// The clock counts host writes, the last write of every page is kept as a 32 bit clock value
+// (lifetimes of 2^32 host writes and more wrap around). Lifetimes are counted in log-linear bins,
+// overall and per zone, and can be queried as a prior (quantiles, survival) by prediction-based gc.
+class Lifetimes {
+ public:
+   // 4 linear sub-bins per power of two: bins 0-3 hold 0-3, then [2^e, 2^(e+1)) is split in four
+   static constexpr uint64_t subBins = 4;
+   static constexpr uint64_t bins = subBins + (32 - 2) * subBins;
+   static uint64_t bin(uint32_t v) {
+      if (v < subBins) {
+         return v;
+      }
+      uint64_t e = std::bit_width(v) - 1;
+      return subBins + (e - 2) * subBins + ((v >> (e - 2)) & (subBins - 1));
+   }
+   static uint64_t binLower(uint64_t b) {
+      if (b < subBins) {
+         return b;
+      }
+      uint64_t e = (b - subBins) / subBins + 2;
+      return (1ULL << e) + ((b - subBins) % subBins << (e - 2));
+   }
+   static uint64_t binUpper(uint64_t b) { return b + 1 < bins ? binLower(b + 1) : 1ULL << 32; } // exclusive
+
+ private:
+   std::vector<uint32_t> _lastWrite; // 0: not written (or trimmed)
+   uint32_t _clock = 0;
+   std::vector<uint64_t> _hist;      // [zone * bins + bin], zone 0 is overall, zone z + 1 is zone z
+   uint64_t _zones;
+
+ public:
+   Lifetimes(uint64_t logicalPages, uint64_t zones) : _lastWrite(logicalPages, 0), _hist((zones + 1) * bins, 0), _zones(zones) {}
+
+   uint64_t zones() const { return _zones; }
+
+   void write(uint64_t logPage, uint16_t zone) {
+      if (++_clock == 0) {
+         _clock = 1;
+      }
+      uint32_t last = _lastWrite[logPage];
+      if (last != 0) {
+         uint64_t b = bin(_clock - last);
+         _hist[b]++;
+         if (_zones > 0) {
+            _hist[(zone + 1) * bins + b]++;
+         }
+      }
+      _lastWrite[logPage] = _clock;
+   }
+
+   // the last write is a random access, issued early it overlaps with the mapping lookup of the write
+   void prefetch(uint64_t logPage) const { __builtin_prefetch(&_lastWrite[logPage], 1); }
+
+   // a trimmed page is dead, its next write is not an overwrite
+   void trim(uint64_t logPage) { _lastWrite[logPage] = 0; }
+
+   // keeps the last writes, e.g. to drop the initial load from the histograms
+   void resetHistograms() { std::fill(_hist.begin(), _hist.end(), 0); }
+
+   // zone -1: overall
+   const uint64_t* hist(int64_t zone = -1) const { return &_hist[(zone + 1) * bins]; }
+
+   uint64_t count(int64_t zone = -1) const {
+      uint64_t c = 0;
+      for (uint64_t b = 0; b < bins; b++) {
+         c += hist(zone)[b];
+      }
+      return c;
+   }
+
+   // lower bound of the bin that holds the q quantile of the lifetimes
+   uint64_t quantile(double q, int64_t zone = -1) const {
+      uint64_t total = count(zone);
+      uint64_t sum = 0;
+      for (uint64_t b = 0; b < bins; b++) {
+         sum += hist(zone)[b];
+         if (sum > 0 && sum >= q * total) {
+            return binLower(b);
+         }
+      }
+      return 0;
+   }
+
+   // fraction of the lifetimes that are longer than age (bin resolution)
+   double survival(uint64_t age, int64_t zone = -1) const {
+      uint64_t total = count(zone);
+      uint64_t longer = 0;
+      for (uint64_t b = bin(std::min<uint64_t>(age, ~0U)) + 1; b < bins; b++) {
+         longer += hist(zone)[b];
+      }
+      return total ? (double)longer / total : 0;
+   }
+
+   // ages of the pages that are still alive (written, not yet overwritten or trimmed), censored lifetimes
+   std::vector<uint64_t> aliveAges() const {
+      std::vector<uint64_t> ages(bins, 0);
+      for (uint32_t last: _lastWrite) {
+         if (last != 0) {
+            ages[bin(_clock - last)]++;
+         }
+      }
+      return ages;
+   }
+};
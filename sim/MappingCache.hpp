@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../shared/Exceptions.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Cached mapping table of a DRAM-less ssd (DFTL-like).
+// The l2p table is stored in translation pages on flash, only cacheSlots of them are cached.
+// Every mapping lookup or update goes through the cache: a miss reads the translation page from flash,
+// evicting a dirty translation page writes it back. Eviction is CLOCK (second chance).
+// Translation page reads and writes are only counted, they do not occupy flash pages or trigger gc.
+// Translation pages are dense ([0, translationPages)), so the lookup table is a flat array tp -> slot.
+class MappingCache {
+   static constexpr uint32_t notCached = ~0U;
+   static constexpr uint64_t entryBytes = 4;
+   struct Slot {
+      uint64_t tp = ~0ULL;
+      bool referenced = false;
+      bool dirty = false;
+   };
+   std::vector<uint32_t> _tpToSlot;
+   std::vector<Slot> _slots;
+   uint64_t _used = 0;
+   uint64_t _hand = 0;
+   // stats
+   uint64_t _hits = 0;
+   uint64_t _misses = 0;
+   uint64_t _reads = 0;  // translation page reads (misses)
+   uint64_t _writes = 0; // translation page writes (dirty evictions)
+
+ public:
+   const uint64_t entriesPerPage;
+   const uint64_t translationPages;
+   const uint64_t cacheSlots;
+
+   MappingCache(uint64_t logicalPages, uint64_t pageSizeBytes, uint64_t cacheBytes)
+       : entriesPerPage(pageSizeBytes / entryBytes), translationPages((logicalPages + entriesPerPage - 1) / entriesPerPage),
+         cacheSlots(std::min(translationPages, cacheBytes / pageSizeBytes)) {
+      ensurem(cacheSlots > 0, "mapping cache smaller than one translation page");
+      _tpToSlot.assign(translationPages, notCached);
+      _slots.resize(cacheSlots);
+   }
+
+   static uint64_t tableBytes(uint64_t logicalPages) { return logicalPages * entryBytes; }
+
+   uint64_t hits() const { return _hits; }
+   uint64_t misses() const { return _misses; }
+   uint64_t reads() const { return _reads; }
+   uint64_t writes() const { return _writes; }
+
+   // lookup (and update if dirty) of the mapping entry of logPage
+   void access(uint64_t logPage, bool dirty) {
+      uint64_t tp = logPage / entriesPerPage;
+      uint32_t slot = _tpToSlot[tp];
+      if (slot == notCached) [[unlikely]] {
+         slot = load(tp);
+      } else {
+         _hits++;
+      }
+      Slot& s = _slots[slot];
+      s.referenced = true;
+      s.dirty |= dirty;
+   }
+
+   void resetStats() {
+      _hits = 0;
+      _misses = 0;
+      _reads = 0;
+      _writes = 0;
+   }
+
+ private:
+   uint32_t load(uint64_t tp) {
+      _misses++;
+      _reads++;
+      uint64_t slot;
+      if (_used < cacheSlots) {
+         slot = _used++;
+      } else {
+         slot = victim();
+         Slot& v = _slots[slot];
+         if (v.dirty) {
+            _writes++;
+         }
+         _tpToSlot[v.tp] = notCached;
+      }
+      _slots[slot] = Slot{tp, false, false};
+      _tpToSlot[tp] = slot;
+      return slot;
+   }
+
+   // clock: first slot without reference bit, clears the bits it passes
+   uint64_t victim() {
+      while (true) {
+         Slot& s = _slots[_hand];
+         uint64_t slot = _hand;
+         _hand = (_hand + 1) % cacheSlots;
+         if (!s.referenced) {
+            return slot;
+         }
+         s.referenced = false;
+      }
+   }
+};
@@ -4,6 +4,8 @@
 #pragma once
 
 #include "../shared/Exceptions.hpp"
+#include "Lifetime.hpp"
+#include "MappingCache.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -13,6 +15,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 // #include <format>
@@ -24,6 +27,38 @@ using BID = uint64_t;
 using BPOS = uint64_t;
 using GID = int64_t;
 
+// attributes host writes and gc relocations of logical pages to classes (placement handle, zone, lba range)
+// gc relocations count for the class of the last host write of the page, O(1) per write
+class WriteAttribution {
+   std::vector<uint16_t> _ltpClass;
+   std::vector<uint64_t> _hostWrites;
+   std::vector<uint64_t> _gcWrites;
+
+ public:
+   bool enabled() const { return !_ltpClass.empty(); }
+   uint64_t classes() const { return _hostWrites.size(); }
+   const std::vector<uint64_t>& hostWrites() const { return _hostWrites; }
+   const std::vector<uint64_t>& gcWrites() const { return _gcWrites; }
+   void enable(uint64_t classes, uint64_t logicalPages) {
+      ensurem(classes <= std::numeric_limits<uint16_t>::max(), "too many attribution classes");
+      _ltpClass.assign(logicalPages, 0);
+      _hostWrites.assign(classes, 0);
+      _gcWrites.assign(classes, 0);
+   }
+   void host(uint64_t logPage, uint16_t cls) {
+      _ltpClass[logPage] = cls;
+      _hostWrites[cls]++;
+   }
+   void gc(uint64_t logPage) {
+      _gcWrites[_ltpClass[logPage]]++;
+   }
+   uint16_t classOf(uint64_t logPage) const { return _ltpClass[logPage]; }
+   void reset() {
+      std::ranges::fill(_hostWrites, 0);
+      std::ranges::fill(_gcWrites, 0);
+   }
+};
+
 class SSD {
  public:
    constexpr static uint64_t unused = ~0ULL;
@@ -57,9 +92,9 @@ class SSD {
       uint64_t validCnt() const { return _validCnt; }
       uint64_t invalidCnt() const { return pagesPerBlock - _validCnt; }
       uint64_t writePos() const { return _writePos; }
+      uint64_t eraseCount() const { return _eraseCount; }
       const uint64_t pagesPerBlock;
       const BID blockId;
-      std::vector<uint64_t> invalidationTimes;
       int64_t gcAge = -1;
       int64_t gcGeneration = 0;
       int64_t group = -1;
@@ -126,6 +161,13 @@ class SSD {
          _validCnt = 0;
          group = -1;
       }
+      // state of a saved block (SSD::load)
+      void restore(uint64_t writePos, uint64_t eraseCount, std::vector<PID> ptl) {
+         _ptl = std::move(ptl);
+         _writePos = writePos;
+         _eraseCount = eraseCount;
+         _validCnt = std::ranges::count_if(_ptl, [](PID p) { return p != unused; });
+      }
       void print() const {
          std::cout << "age: " << gcAge << " gcGen: " << gcGeneration << " wbgc: " << writtenByGc << " vc: " << _validCnt;
       }
@@ -137,6 +179,30 @@ class SSD {
    std::vector<uint64_t> _mappingUpdatedCnt; // stats
    std::vector<uint64_t> _mappingUpdatedGC;  // stats
    uint64_t _physWrites = 0;
+   uint64_t _trimmedPages = 0;
+   // placement handles (FDP), only tracked with more than one handle
+   WriteAttribution _handles;
+   // zones of the pattern or lba ranges
+   WriteAttribution _zones;
+   // cached mapping table (dram-less), nullptr: full table in dram
+   std::unique_ptr<MappingCache> _mapCache;
+   // page lifetimes in host writes, nullptr: not recorded
+   std::unique_ptr<Lifetimes> _lifetimes;
+   PID _hostPage = unused; // tagged host write that has not reached writePageWithoutCaching yet
+   uint16_t _hostZone = 0;
+   // erase count distribution, updated on every erase: block count per erase count
+   std::vector<uint64_t> _eraseHist;
+   uint64_t _eraseMin = 0;
+   uint64_t _eraseMax = 0;
+   uint64_t _erases = 0;   // including compactions
+   uint64_t _wlWrites = 0; // wear leveling relocations, part of _physWrites
+   bool _wearLeveling = false; // relocations of the wear leveling are running, no gc attribution
+   // block stats, maintained on every block change (track/untrack) instead of scanning all blocks
+   static constexpr int64_t maxGCGeneration = 20; // last generation counts all older ones
+   uint64_t _writtenByGcBlocks = 0;
+   std::vector<uint64_t> _genBlocks;     // blocks per gc generation
+   std::vector<uint64_t> _genValid;      // valid pages per gc generation
+   std::vector<uint64_t> _genValidHist;  // fully written blocks per gc generation and valid count [gen * (pagesPerBlock + 1) + validCnt]
    // stats
    uint64_t gcedNormalBlock = 0;
    uint64_t gcedColdBlock = 0;
@@ -149,10 +215,27 @@ class SSD {
    const decltype(_mappingUpdatedCnt)& mappingUpdatedCnt() const { return _mappingUpdatedCnt; }
    const decltype(_mappingUpdatedGC)& mappingUpdatedGC() const { return _mappingUpdatedGC; }
    uint64_t physWrites() const { return _physWrites; }
+   uint64_t trimmedPages() const { return _trimmedPages; }
+   uint64_t wlWrites() const { return _wlWrites; }
+   uint64_t eraseMin() const { return _eraseMin; }
+   uint64_t eraseMax() const { return _eraseMax; }
+   uint64_t eraseSpread() const { return _eraseMax - _eraseMin; }
+   uint64_t erases() const { return _erases; }
+   uint64_t placementHandles() const { return std::max<uint64_t>(1, _handles.classes()); }
+   const WriteAttribution& handleAttribution() const { return _handles; }
+   const WriteAttribution& zoneAttribution() const { return _zones; }
+   const MappingCache* mapCache() const { return _mapCache.get(); }
+   const Lifetimes* lifetimes() const { return _lifetimes.get(); }
+   Lifetimes* lifetimes() { return _lifetimes.get(); }
+   uint64_t mapReads() const { return _mapCache ? _mapCache->reads() : 0; }
+   uint64_t mapWrites() const { return _mapCache ? _mapCache->writes() : 0; }
    void hackForOptimalWASetPhysWrites(uint64_t phyWrites) { _physWrites = phyWrites; }
+   static uint64_t logicalPagesFor(uint64_t capacityBytes, uint64_t pageSizeBytes, double ssdFill) {
+      return (capacityBytes / pageSizeBytes) * ssdFill;
+   }
    SSD(uint64_t capacityBytes, uint64_t blockSizeBytes, uint64_t pageSizeBytes, double ssdFill)
        : ssdFill(ssdFill), capacityBytes(capacityBytes), blockSizeBytes(blockSizeBytes), pageSizeBytes(pageSizeBytes),
-         blockCount(capacityBytes / blockSizeBytes), pagesPerBlock(blockSizeBytes / pageSizeBytes), logicalPages((capacityBytes / pageSizeBytes) * ssdFill), physicalPages(blockCount * pagesPerBlock),
+         blockCount(capacityBytes / blockSizeBytes), pagesPerBlock(blockSizeBytes / pageSizeBytes), logicalPages(logicalPagesFor(capacityBytes, pageSizeBytes, ssdFill)), physicalPages(blockCount * pagesPerBlock),
          writeBufferSize(static_cast<uint64_t>(logicalPages * writeBufferSizePct)) {
       // init by sequentially filling blocks
       _ltpMapping.resize(logicalPages);
@@ -162,6 +245,55 @@ class SSD {
       for (unsigned z = 0; z < blockCount; z++) {
          _blocks.emplace_back(Block(pagesPerBlock, z));
       }
+      _eraseHist.assign(1, blockCount);
+      _genBlocks.assign(maxGCGeneration, 0);
+      _genValid.assign(maxGCGeneration, 0);
+      _genValidHist.assign(maxGCGeneration * (pagesPerBlock + 1), 0);
+      for (auto& b: _blocks) {
+         track(b);
+      }
+   }
+
+   void enablePlacementHandles(uint64_t handles) {
+      if (handles <= 1) {
+         return;
+      }
+      _handles.enable(handles, logicalPages);
+   }
+
+   void enableZoneAttribution(uint64_t zones) {
+      if (zones > 0) {
+         _zones.enable(zones, logicalPages);
+      }
+   }
+
+   // only cacheBytes of the mapping table are cached, 0: full table
+   void enableMappingCache(uint64_t cacheBytes) {
+      if (cacheBytes == 0 || cacheBytes >= MappingCache::tableBytes(logicalPages)) {
+         _mapCache.reset();
+         return;
+      }
+      _mapCache = std::make_unique<MappingCache>(logicalPages, pageSizeBytes, cacheBytes);
+   }
+
+   // records the lifetime of every host write, per zone if zones > 0
+   void enableLifetimes(uint64_t zones) {
+      _lifetimes = std::make_unique<Lifetimes>(logicalPages, zones);
+   }
+
+   // called for every host write, gc relocations are attributed to the handle/zone of the last host write
+   void tagHostWrite(PID logPage, uint8_t handle, uint16_t zone = 0) {
+      if (_lifetimes) {
+         _lifetimes->prefetch(logPage);
+         _hostPage = logPage;
+         _hostZone = zone;
+      }
+      if (_handles.enabled()) {
+         _handles.host(logPage, handle);
+      }
+      if (_zones.enabled()) {
+         _zones.host(logPage, zone);
+      }
    }
 
    BID getBlockId(PHY physAddr) const { return physAddr / pagesPerBlock; }
@@ -203,54 +335,137 @@ class SSD {
          // std::cout << "set group: " << group << std::endl;
          block.group = group;
       }
+      if (_mapCache) {
+         _mapCache->access(logPage, true);
+      }
       uint64_t addr = _ltpMapping.at(logPage);
       if (addr != unused && addr != incache) { // page is updated, not new
          uint64_t z = getBlockId(addr);
          uint64_t p = getPagePos(addr);
          ensure(z < _blocks.size());
          Block& b = _blocks.at(z);
-         b.setUnused(p);
+         invalidate(b, p);
       }
       uint64_t writePos = block.write(logPage);
+      // a gc run before the host write may relocate the same page first, it is counted then,
+      // the clock only moves with host writes so the lifetime is the same
+      if (_lifetimes && logPage == _hostPage) {
+         _lifetimes->write(logPage, _hostZone);
+         _hostPage = unused;
+      }
+      // hot path of the block stats, only the valid count changes
+      uint64_t gen = std::min(block.gcGeneration, maxGCGeneration - 1);
+      _genValid[gen]++;
+      if (block.fullyWritten()) {
+         _genValidHist[gen * (pagesPerBlock + 1) + block.validCnt()]++;
+      }
       _ltpMapping[logPage] = getPhyAddr(block.blockId, writePos);
       _mappingUpdatedCnt[logPage]++;
       _physWrites++;
       // writtenPages.push_back(logPage);
    }
 
+   // deallocates a logical page (TRIM), gc does not have to move it anymore
+   // returns false if the page was not mapped
+   bool trimPage(PID logPage) {
+      if (writeBufferSize > 0) {
+         auto it = writeBufferMap.find(logPage);
+         if (it != writeBufferMap.end()) {
+            writeBuffer.erase(it->second);
+            writeBufferMap.erase(it);
+         }
+      }
+      if (_mapCache) {
+         _mapCache->access(logPage, true);
+      }
+      if (_lifetimes) {
+         _lifetimes->trim(logPage);
+      }
+      uint64_t addr = _ltpMapping.at(logPage);
+      if (addr == unused || addr == incache) {
+         return false;
+      }
+      ensure(getBlockId(addr) < _blocks.size());
+      invalidate(_blocks[getBlockId(addr)], getPagePos(addr));
+      _ltpMapping[logPage] = unused;
+      _trimmedPages++;
+      return true;
+   }
+
+   uint64_t trimRange(PID first, uint64_t count) {
+      ensure(first + count <= logicalPages);
+      uint64_t trimmed = 0;
+      for (PID p = first; p < first + count; p++) {
+         trimmed += trimPage(p);
+      }
+      return trimmed;
+   }
+
    void setLtpMappingStateCached(PID pid) {
       _ltpMapping[pid] = SSD::incache;
    }
 
    void eraseBlock(Block& block) {
-      block.erase();
+      mutate(block, [](Block& b) { b.erase(); });
+      countErase(block);
    }
 
    void eraseBlock(BID blockId) {
       ensure(blockId < _blocks.size());
-      _blocks[blockId].erase();
+      eraseBlock(_blocks[blockId]);
       ensure(_blocks[blockId].isErased());
    }
 
+   // erase count with fraction q of the blocks at or below it, walks the histogram from min to max
+   uint64_t eraseCountPercentile(double q) const {
+      uint64_t target = std::ceil(q * blockCount);
+      uint64_t sum = 0;
+      for (uint64_t c = _eraseMin; c <= _eraseMax; c++) {
+         sum += _eraseHist[c];
+         if (sum >= target) {
+            return c;
+         }
+      }
+      return _eraseMax;
+   }
+
+   // runs relocations of the wear leveling: their writes count as physical and wear leveling writes,
+   // but not as gc writes of the handles/zones, wlWAF is reported on its own
+   template <typename Fun>
+   void wearLevelingWrites(Fun&& fun) {
+      uint64_t before = _physWrites;
+      _wearLeveling = true;
+      fun();
+      _wearLeveling = false;
+      _wlWrites += _physWrites - before;
+   }
+
    void compactBlock(uint64_t block) {
       compactBlock(_blocks[block]);
    }
    void compactBlock(Block& block) { // compacts a block by moving active data to the front ~ erase
-      block.compactNoMappingUpdate();
-      block.gcGeneration++;
       if (block.writtenByGc) {
          gcedColdBlock++;
       } else {
          gcedNormalBlock++;
       }
-      block.writtenByGc = true;
+      mutate(block, [](Block& b) {
+         b.compactNoMappingUpdate();
+         b.gcGeneration++;
+         b.writtenByGc = true;
+      });
+      countErase(block);
       // update mapping for all pages in block
       for (BPOS p = 0; p < block.writePos(); p++) {
          PID logPage = block.ptl()[p];
          ensure(block.ptl()[p] != unused);
          _ltpMapping[logPage] = getPhyAddr(block.blockId, p);
+         if (_mapCache) {
+            _mapCache->access(logPage, true);
+         }
          _mappingUpdatedGC[logPage]++;
          _physWrites++;
+         countGCWrite(logPage);
       }
    }
 
@@ -265,10 +480,11 @@ class SSD {
       } else {
          gcedNormalBlock++;
       }
-      destination.writtenByGc = true;
+      mutate(destination, [](Block& b) { b.writtenByGc = true; });
       BPOS p = 0;
       while (p < pagesPerBlock && destination.canWrite()) {
          if (source.ptl()[p] != unused) {
+            countGCWrite(source.ptl()[p]);
             writePageWithoutCaching(source.ptl()[p], destination);
          }
          p++;
@@ -293,6 +509,7 @@ class SSD {
             Block& destination = _blocks[destinationId];
             // std::cout << "moveValidPageTo: dest: " << destinationId << std::endl;
             if (destination.canWrite()) { // skip full destinations
+               countGCWrite(lba);
                writePageWithoutCaching(source.ptl()[p], destination, groupId);
             } else if (firstFullDestinationId == -1) {
                // std::cout << "moveValidPageTo: first dest full: " << destinationId << std::endl;
@@ -309,6 +526,36 @@ class SSD {
       return firstFullDestinationId;
    }
 
+   // moves all valid pages of the victim to destination(logPage), which has to be writable, and erases the victim.
+   // destinations opened by it are gc blocks one generation above the victim
+   void relocateBlock(BID victimId, const std::function<BID(PID)>& destination) {
+      Block& victim = _blocks[victimId];
+      if (victim.writtenByGc) {
+         gcedColdBlock++;
+      } else {
+         gcedNormalBlock++;
+      }
+      int64_t generation = victim.gcGeneration + 1;
+      for (BPOS p = 0; p < victim.writePos(); p++) {
+         PID logPage = victim.ptl()[p];
+         if (logPage == unused) {
+            continue;
+         }
+         Block& dest = _blocks[destination(logPage)];
+         ensure(dest.canWrite());
+         if (dest.writePos() == 0) {
+            mutate(dest, [&](Block& b) {
+               b.writtenByGc = true;
+               b.gcGeneration = generation;
+            });
+         }
+         countGCWrite(logPage);
+         writePageWithoutCaching(logPage, dest);
+      }
+      eraseBlock(victim);
+      mutate(victim, [](Block& b) { b.gcGeneration = 0; });
+   }
+
    // compacts blocks until a block is completely free
    // returns the free block and the last (not-full) gc block
    std::tuple<BID, BID> compactUntilFreeBlock(BID gcBlockId, std::function<BID()> nextBlock) {
@@ -329,8 +576,8 @@ class SSD {
          victimId = nextBlock();
       }
       Block& nowFree = _blocks[victimId];
-      nowFree.erase();
-      nowFree.gcGeneration = 0;
+      eraseBlock(nowFree);
+      mutate(nowFree, [](Block& b) { b.gcGeneration = 0; });
       return std::make_tuple(victimId, gcBlockId);
    }
 
@@ -366,8 +613,8 @@ class SSD {
          ensure(_blocks[victimId].group == groupId);
       } while (true);
       Block& nowFree = _blocks[victimId];
-      nowFree.erase();
-      nowFree.gcGeneration = 0;
+      eraseBlock(nowFree);
+      mutate(nowFree, [](Block& b) { b.gcGeneration = 0; });
       return std::make_tuple(victimId, -1);
    }
 
@@ -403,6 +650,69 @@ class SSD {
 
    void resetPhysicalCounters() {
       _physWrites = 0;
+      _trimmedPages = 0;
+      _wlWrites = 0;
+      _handles.reset();
+      _zones.reset();
+      if (_mapCache) {
+         _mapCache->resetStats();
+      }
+   }
+
+   // moves the block from its previous erase count to the new one, counts only grow
+   void countErase(const Block& block) {
+      uint64_t c = block.eraseCount();
+      if (c >= _eraseHist.size()) {
+         _eraseHist.resize(c + 1, 0);
+      }
+      _eraseHist[c - 1]--;
+      _eraseHist[c]++;
+      _erases++;
+      _eraseMax = std::max(_eraseMax, c);
+      while (_eraseHist[_eraseMin] == 0) {
+         _eraseMin++;
+      }
+   }
+
+   // block stats: remove the block before a change and add it again after
+   void untrack(const Block& b) { account(b, -1); }
+   void track(const Block& b) { account(b, 1); }
+   void account(const Block& b, int64_t sign) {
+      uint64_t gen = std::min(b.gcGeneration, maxGCGeneration - 1);
+      _genBlocks[gen] += sign;
+      _genValid[gen] += sign * (int64_t)b.validCnt();
+      if (b.fullyWritten()) {
+         _genValidHist[gen * (pagesPerBlock + 1) + b.validCnt()] += sign;
+      }
+      _writtenByGcBlocks += sign * b.writtenByGc;
+   }
+   void invalidate(Block& b, BPOS pos) {
+      b.setUnused(pos);
+      uint64_t gen = std::min(b.gcGeneration, maxGCGeneration - 1);
+      _genValid[gen]--;
+      if (b.fullyWritten()) {
+         uint64_t* hist = &_genValidHist[gen * (pagesPerBlock + 1)];
+         hist[b.validCnt() + 1]--;
+         hist[b.validCnt()]++;
+      }
+   }
+   template <typename Fun>
+   void mutate(Block& b, Fun&& fun) {
+      untrack(b);
+      fun(b);
+      track(b);
+   }
+
+   void countGCWrite(PID logPage) {
+      if (_wearLeveling) {
+         return;
+      }
+      if (_handles.enabled()) {
+         _handles.gc(logPage);
+      }
+      if (_zones.enabled()) {
+         _zones.gc(logPage);
+      }
    }
 
    void printInfo() const {
@@ -410,21 +720,30 @@ class SSD {
       cout << "blockCnt: " << blockCount << " pagesPerBlock: " << pagesPerBlock << " logicalPages: " << logicalPages << " ssdfill: " << ssdFill << endl;
    }
 
+   // fully written blocks per valid count [0, pagesPerBlock], all gc generations
+   std::vector<uint64_t> validCountHist() const {
+      std::vector<uint64_t> hist(pagesPerBlock + 1, 0);
+      for (int64_t gen = 0; gen < maxGCGeneration; gen++) {
+         for (uint64_t v = 0; v <= pagesPerBlock; v++) {
+            hist[v] += _genValidHist[gen * (pagesPerBlock + 1) + v];
+         }
+      }
+      return hist;
+   }
+
+   // O(generations * pagesPerBlock), independent of the block count
    void stats() {
-      auto writtenByGc = std::count_if(_blocks.begin(), _blocks.end(), [](Block& b) { return b.writtenByGc; });
-      int64_t maxGCAge = 20;
-      std::vector<uint64_t> gcGenerations(maxGCAge, 0);
-      std::vector<uint64_t> gcGenerationValid(maxGCAge, 0);
+      uint64_t writtenByGc = _writtenByGcBlocks;
+      int64_t maxGCAge = maxGCGeneration;
+      const std::vector<uint64_t>& gcGenerations = _genBlocks;
+      const std::vector<uint64_t>& gcGenerationValid = _genValid;
       std::vector<uint64_t> gcGenerationValidMin(maxGCAge, std::numeric_limits<uint64_t>::max());
-      // count gc generations
-      for (auto& b: _blocks) {
-         auto idx = std::min(b.gcGeneration, maxGCAge - 1);
-         gcGenerations[idx]++;
-         gcGenerationValid[idx] += b.validCnt();
-         if (b.fullyWritten()) {
-            if (b.validCnt() > pagesPerBlock)
-               raise(SIGINT);
-            gcGenerationValidMin[idx] = std::min(gcGenerationValidMin[idx], b.validCnt());
+      for (int64_t gen = 0; gen < maxGCAge; gen++) {
+         for (uint64_t v = 0; v <= pagesPerBlock; v++) {
+            if (_genValidHist[gen * (pagesPerBlock + 1) + v] > 0) {
+               gcGenerationValidMin[gen] = v;
+               break;
+            }
          }
       }
       cout << "writtenByGC: " << writtenByGc << " (" << std::round((float)writtenByGc / blockCount * 100) << "%)" << " gcedNormal: " << gcedNormalBlock << " gcedCold: " << gcedColdBlock << endl;
@@ -488,6 +807,64 @@ class SSD {
       cout << endl;
    }
 
+   // binary snapshot of the flash (blocks with their pages and erase counts), e.g. to keep an emulated drive between runs
+   void save(std::ostream& out) const {
+      auto put = [&](uint64_t v) { out.write(reinterpret_cast<const char*>(&v), sizeof(v)); };
+      put(blockCount);
+      put(pagesPerBlock);
+      put(logicalPages);
+      for (const Block& b: _blocks) {
+         put(b.writePos());
+         put(b.eraseCount());
+         put(b.gcGeneration);
+         put(b.writtenByGc);
+         out.write(reinterpret_cast<const char*>(b.ptl().data()), pagesPerBlock * sizeof(PID));
+      }
+   }
+
+   // restores a snapshot of the same geometry, the mapping and block stats are rebuilt from the blocks
+   bool load(std::istream& in) {
+      auto get = [&]() {
+         uint64_t v = 0;
+         in.read(reinterpret_cast<char*>(&v), sizeof(v));
+         return v;
+      };
+      if (get() != blockCount || get() != pagesPerBlock || get() != logicalPages) {
+         return false;
+      }
+      std::ranges::fill(_ltpMapping, unused);
+      std::vector<PID> ptl(pagesPerBlock);
+      _eraseHist.assign(1, 0);
+      for (Block& b: _blocks) {
+         uint64_t writePos = get();
+         uint64_t eraseCount = get();
+         int64_t gcGeneration = get();
+         bool writtenByGc = get();
+         in.read(reinterpret_cast<char*>(ptl.data()), pagesPerBlock * sizeof(PID));
+         ensurem(in.good(), "truncated ssd snapshot");
+         mutate(b, [&](Block& b) {
+            b.restore(writePos, eraseCount, ptl);
+            b.gcGeneration = gcGeneration;
+            b.writtenByGc = writtenByGc;
+         });
+         for (BPOS p = 0; p < writePos; p++) {
+            if (ptl[p] != unused) {
+               _ltpMapping[ptl[p]] = getPhyAddr(b.blockId, p);
+            }
+         }
+         if (eraseCount >= _eraseHist.size()) {
+            _eraseHist.resize(eraseCount + 1, 0);
+         }
+         _eraseHist[eraseCount]++;
+      }
+      _eraseMax = _eraseHist.size() - 1;
+      _eraseMin = 0;
+      while (_eraseHist[_eraseMin] == 0) {
+         _eraseMin++;
+      }
+      return true;
+   }
+
    void writeStatsFile(std::string prefix) {
       /*
       auto writeToFile = [&](string filename, std::vector<uint64_t>& vec){
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../shared/Exceptions.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Spatial sampling of the logical page space of traces (similar to SHARDS).
+// A page belongs to the sample iff hash(page) mod P < T, with T = rate * P.
+// As the decision only depends on the page id, every write to a sampled page is kept,
+// so the sampled stream keeps the per-page update frequencies of the full stream.
+// Sampled pages get dense ids [0, maxPages) on their first access, to be replayed on an SSD scaled down by the rate.
+// Synthetic patterns are not sampled, they are generated directly on the scaled down page space (see runSampled).
+class SpatialSampler {
+   static constexpr uint64_t modulus = 1ULL << 24;
+   static constexpr uint64_t empty = ~0ULL;
+   const uint64_t threshold;
+   uint64_t _sampledPages = 0;
+   // open addressing, linear probing: sampled page -> dense id
+   std::vector<uint64_t> _keys;
+   std::vector<uint64_t> _ids;
+   uint64_t _mask;
+
+ public:
+   const double rate;
+   const uint64_t logicalPages;
+   // upper bound of the sampled pages: the count is binomial(logicalPages, rate), mean + 6 sigma
+   const uint64_t maxPages;
+
+   SpatialSampler(double rate, uint64_t logicalPages)
+       : threshold(std::min<uint64_t>(modulus, std::llround(rate * modulus))), rate(rate), logicalPages(logicalPages),
+         maxPages(std::min<uint64_t>(logicalPages, std::ceil(logicalPages * rate + 6 * std::sqrt(logicalPages * rate * std::max(0.0, 1 - rate))) + 1)) {
+      ensurem(rate > 0 && rate <= 1, "sample rate must be in (0, 1]");
+      uint64_t slots = std::bit_ceil(std::max<uint64_t>(1024, logicalPages * rate * 1.1) * 2);
+      _keys.resize(slots, empty);
+      _ids.resize(slots);
+      _mask = slots - 1;
+   }
+
+   static uint64_t hash(uint64_t page) {
+      // splitmix64 finalizer
+      page += 0x9e3779b97f4a7c15ULL;
+      page = (page ^ (page >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      page = (page ^ (page >> 27)) * 0x94d049bb133111ebULL;
+      return page ^ (page >> 31);
+   }
+
+   bool isSampled(uint64_t page) const {
+      return (hash(page) & (modulus - 1)) < threshold;
+   }
+
+   // sampled pages accessed so far
+   uint64_t sampledPages() const { return _sampledPages; }
+
+   // dense id of a sampled page, the next free id on its first access, -1 if the page is not part of the sample
+   int64_t map(uint64_t page) {
+      uint64_t h = hash(page);
+      if ((h & (modulus - 1)) >= threshold) {
+         return -1;
+      }
+      for (uint64_t slot = (h >> 24) & _mask;; slot = (slot + 1) & _mask) {
+         if (_keys[slot] == page) {
+            return _ids[slot];
+         }
+         if (_keys[slot] == empty) {
+            ensurem(_sampledPages < maxPages, "more sampled pages than the scaled down ssd holds");
+            if ((_sampledPages + 1) * 2 > _keys.size()) {
+               grow();
+               insert(page, _sampledPages);
+            } else {
+               _keys[slot] = page;
+               _ids[slot] = _sampledPages;
+            }
+            return _sampledPages++;
+         }
+      }
+   }
+
+   // capacity of the scaled down ssd, fill and pages per block stay the same.
+   // smallest number of blocks whose logical pages (same rounding as SSD::logicalPagesFor) hold the pages,
+   // the few extra logical pages are only written by the initial load.
+   static uint64_t scaledCapacity(uint64_t pages, uint64_t blockSizeBytes, uint64_t pageSizeBytes, double ssdFill) {
+      uint64_t pagesPerBlock = blockSizeBytes / pageSizeBytes;
+      auto logicalPagesOf = [&](uint64_t blocks) -> uint64_t { return (blocks * pagesPerBlock) * ssdFill; };
+      uint64_t blocks = pages / (pagesPerBlock * ssdFill);
+      while (logicalPagesOf(blocks) < pages) {
+         blocks++;
+      }
+      return blocks * blockSizeBytes;
+   }
+
+ private:
+   void insert(uint64_t page, uint64_t id) {
+      uint64_t slot = (hash(page) >> 24) & _mask;
+      while (_keys[slot] != empty) {
+         slot = (slot + 1) & _mask;
+      }
+      _keys[slot] = page;
+      _ids[slot] = id;
+   }
+
+   void grow() {
+      std::vector<uint64_t> keys = std::move(_keys);
+      std::vector<uint64_t> ids = std::move(_ids);
+      _keys.assign(keys.size() * 2, empty);
+      _ids.resize(keys.size() * 2);
+      _mask = _keys.size() - 1;
+      for (uint64_t i = 0; i < keys.size(); i++) {
+         if (keys[i] != empty) {
+            insert(keys[i], ids[i]);
+         }
+      }
+   }
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Exceptions.hpp"
+#include "PatternGen.hpp"
+#include "Seed.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Time varying workload: a sequence of phases, each with its own pattern generator and length.
+// Spec: phases separated by ';', fields by ',', e.g.
+//   "pattern=zipf,zipf=0.9,writes=2;pattern=zones,zones=s0.9 f0.1 s0.1 f0.9,writes=3;pattern=zipf,zipf=0.9,writes=2,drift=0.5"
+// fields: pattern, zones, zipf, alpha, beta, writes (disk overwrites, fractions allowed),
+//         drift (fraction of the lba space the pattern is rotated by over the phase, moves the hot set,
+//         the next phase starts unrotated)
+// All generators are built upfront, a phase switch is one compare per access.
+// Progress is counted in accesses of the pattern (before sampling), in disk overwrites of the full pattern space.
+class WorkloadSchedule {
+ public:
+   struct Phase {
+      std::string spec;
+      std::unique_ptr<iob::PatternGen> pg;
+      uint64_t accesses = 0;     // length of the phase
+      double drift = 0;          // fraction of the lba space
+      double driftPerAccess = 0; // pages
+   };
+
+ private:
+   std::vector<Phase> _phases;
+   const uint64_t _logicalPages;
+   uint64_t _phase = 0;
+   uint64_t _accessInPhase = 0;
+   uint64_t _driftOffset = 0;
+
+ public:
+   WorkloadSchedule(const std::string& spec, const iob::PatternGen::Options& base, uint64_t seed) : _logicalPages(base.logicalPages) {
+      std::stringstream phases(spec);
+      for (std::string phaseSpec; std::getline(phases, phaseSpec, ';');) {
+         if (phaseSpec.empty()) {
+            continue;
+         }
+         iob::PatternGen::Options options = base;
+         double writes = base.writesInDiskOverwrites;
+         double drift = 0;
+         std::stringstream fields(phaseSpec);
+         for (std::string field; std::getline(fields, field, ',');) {
+            auto eq = field.find('=');
+            ensurem(eq != std::string::npos, "schedule field needs key=value: " + field);
+            std::string key = field.substr(0, eq);
+            std::string value = field.substr(eq + 1);
+            if (key == "pattern") {
+               options.patternString = value;
+            } else if (key == "zones") {
+               options.zonesString = value;
+            } else if (key == "zipf") {
+               options.skewFactor = std::stod(value);
+            } else if (key == "alpha") {
+               options.alpha = std::stod(value);
+            } else if (key == "beta") {
+               options.beta = std::stod(value);
+            } else if (key == "writes") {
+               writes = std::stod(value);
+            } else if (key == "drift") {
+               drift = std::stod(value);
+            } else {
+               ensurem(false, "unknown schedule field: " + key);
+            }
+         }
+         ensurem(!options.patternString.contains("zones") || !options.zonesString.empty(), "schedule phase needs zones: " + phaseSpec);
+         ensurem(!options.patternString.contains("zipf") || options.skewFactor > 0, "schedule phase needs zipf skew: " + phaseSpec);
+         ensurem(writes > 0 && drift >= 0 && drift <= 1, "schedule phase needs writes > 0 and drift in [0, 1]: " + phaseSpec);
+         options.seed = Seed(seed).split(_phases.size()).value;
+         Phase phase;
+         phase.spec = phaseSpec;
+         phase.pg = std::make_unique<iob::PatternGen>(options);
+         phase.accesses = std::max<uint64_t>(1, writes * _logicalPages);
+         phase.drift = drift;
+         phase.driftPerAccess = drift * _logicalPages / phase.accesses;
+         _phases.push_back(std::move(phase));
+      }
+      ensurem(!_phases.empty(), "empty schedule");
+   }
+
+   const std::vector<Phase>& phases() const { return _phases; }
+   uint64_t phase() const { return _phase; }
+   iob::PatternGen& pg() { return *_phases[_phase].pg; }
+
+   // total length of all phases in disk overwrites
+   double totalWrites() const {
+      uint64_t accesses = 0;
+      for (auto& p: _phases) {
+         accesses += p.accesses;
+      }
+      return (double)accesses / _logicalPages;
+   }
+
+   // back to the start of the first phase (after the initial load), generators keep their state
+   void restart() {
+      _phase = 0;
+      _accessInPhase = 0;
+      _driftOffset = 0;
+   }
+
+   // next access of the schedule, the last phase continues until the run ends
+   // the drift of the access stays set until the next one, rotate() applies it to the discards of the access
+   int64_t access(std::mt19937_64& gen, uint8_t& handle, int* zoneId) {
+      Phase& p = _phases[_phase];
+      int64_t page = p.pg->accessPatternGenerator(gen, handle, zoneId);
+      _driftOffset = _accessInPhase * p.driftPerAccess;
+      if (_driftOffset != 0) {
+         page = rotate(page);
+         // lba ranges of the rotated page
+         if (p.pg->placement == iob::PatternGen::Placement::Ranges) {
+            handle = p.pg->placementHandle(page, 0);
+         }
+      }
+      if (++_accessInPhase == p.accesses && _phase + 1 < _phases.size()) {
+         // every phase starts with its pattern in place
+         _phase++;
+         _accessInPhase = 0;
+      }
+      return page;
+   }
+
+   bool rotating() const { return _driftOffset != 0; }
+
+   // one-shot check at setup: runs all phases of the spec on a small lba space, every ranges handle has to be the
+   // range of the written (drifted) page, across the phase changes too. Trace and zns phases need their own lba space
+   static void checkRangesPlacement(const std::string& spec, iob::PatternGen::Options base) {
+      if (!base.placementString.starts_with("ranges") || spec.contains("trace") || spec.contains("zns")) {
+         return;
+      }
+      base.logicalPages = 4096;
+      base.totalWrites = base.writesInDiskOverwrites * base.logicalPages;
+      WorkloadSchedule check(spec, base, 1);
+      std::mt19937_64 gen(1);
+      uint8_t handle = 0;
+      int zone = 0;
+      for (uint64_t i = 0, n = check.totalWrites() * base.logicalPages; i < n; i++) {
+         iob::PatternGen& pg = check.pg();
+         uint64_t page = check.access(gen, handle, &zone);
+         ensurem(handle == pg.placementHandle(page, zone), "schedule: ranges placement handle of another lba range in phase " + std::to_string(check.phase()));
+      }
+   }
+
+   // applies the current drift to a page of the pattern (also used for discards)
+   uint64_t rotate(uint64_t page) const {
+      page += _driftOffset % _logicalPages;
+      return page >= _logicalPages ? page - _logicalPages : page;
+   }
+};
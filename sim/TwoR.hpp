@@ -1,4 +1,5 @@
 #include "SSD.hpp"
+#include "Seed.hpp"
 
 #include <algorithm>
 #include <list>
@@ -22,15 +23,15 @@ class TwoR {
    std::list<uint64_t>::iterator curBlkPtr;
 
    // frequency generator to choose region (normal vs. cold)
-   std::random_device rd;
-   std::default_random_engine generator{rd()};
+   std::default_random_engine generator;
    std::uniform_int_distribution<int> distribution{0, 100};
 
    SSD& ssd;
    std::string gcAlgorithm;
 
  public:
-   TwoR(SSD& ssd, std::string gcAlgorithm) : ssd(ssd), gcAlgorithm(gcAlgorithm) {
+   // seed 0: random
+   TwoR(SSD& ssd, std::string gcAlgorithm, uint64_t seed = 0) : generator(Seed(seed).value), ssd(ssd), gcAlgorithm(gcAlgorithm) {
       // Initialize free block list
       for (unsigned z = 0; z < ssd.blockCount; z++) {
          freeBlocks.push_back(z);
@@ -54,7 +55,7 @@ class TwoR {
       curBlkPtr = fifoList.end();
    }
 
-   void writePage(uint64_t pageId) {
+   void writePage(uint64_t pageId, uint8_t handle = 0) { // single write stream, handle is ignored
       if (!ssd.blocks()[currentBlock].canWrite()) {
          fifoList.push_back(currentBlock);
          normalBlocks.push_back(currentBlock);
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "Exceptions.hpp"
+#include "SSD.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <vector>
+
+// Zoned device model on top of SSD, every block is a zone (erase size = zone size).
+// Zones are only written at their write pointer and become writable again after a reset.
+// Active zones (open or closed, partially written) are limited by maxActiveZones, zones that can be written
+// right now (open) by maxOpenZones. A closed zone keeps its write pointer and is opened again for the next write.
+// There is no device gc, the ssd mapping is only used to keep track of which pages the host still considers valid.
+class ZonedSSD {
+ public:
+   enum class ZoneState : uint8_t {
+      Empty,
+      Open,
+      Closed,
+      Full
+   };
+   SSD& ssd;
+   const uint64_t maxActiveZones;
+   const uint64_t maxOpenZones;
+
+ private:
+   std::vector<ZoneState> _state;
+   uint64_t _activeZones = 0;
+   uint64_t _openZones = 0;
+   uint64_t _resets = 0;
+   uint64_t _closes = 0;
+
+ public:
+   // maxOpenZones 0: same as maxActiveZones
+   ZonedSSD(SSD& ssd, uint64_t maxActiveZones, uint64_t maxOpenZones = 0)
+       : ssd(ssd), maxActiveZones(maxActiveZones), maxOpenZones(maxOpenZones ? maxOpenZones : maxActiveZones), _state(ssd.blockCount, ZoneState::Empty) {
+      ensurem(maxActiveZones >= 2, "zns needs at least two active zones");
+      ensurem(this->maxOpenZones >= 2 && this->maxOpenZones <= maxActiveZones, "zns needs two to max active open zones");
+   }
+   uint64_t zoneCount() const { return ssd.blockCount; }
+   uint64_t zoneCapacity() const { return ssd.pagesPerBlock; }
+   uint64_t activeZones() const { return _activeZones; }
+   uint64_t openZones() const { return _openZones; }
+   uint64_t resets() const { return _resets; }
+   uint64_t closes() const { return _closes; }
+   ZoneState state(BID zone) const { return _state[zone]; }
+   BPOS writePointer(BID zone) const { return ssd.blocks(zone).writePos(); }
+
+   // empty zones become active, closed ones already are
+   void open(BID zone) {
+      ensure(_state[zone] == ZoneState::Empty || _state[zone] == ZoneState::Closed);
+      ensurem(_openZones < maxOpenZones, "open zone limit exceeded");
+      if (_state[zone] == ZoneState::Empty) {
+         ensurem(_activeZones < maxActiveZones, "active zone limit exceeded");
+         _activeZones++;
+      }
+      _state[zone] = ZoneState::Open;
+      _openZones++;
+   }
+
+   // frees an open zone slot, the zone stays active
+   void close(BID zone) {
+      ensure(_state[zone] == ZoneState::Open);
+      _state[zone] = ZoneState::Closed;
+      _openZones--;
+      _closes++;
+   }
+
+   // regular zone write, has to be at the write pointer
+   void write(BID zone, BPOS offset, PID logPage) {
+      ensure(_state[zone] == ZoneState::Open);
+      ensurem(offset == writePointer(zone), "zone write not at write pointer");
+      ssd.writePage(logPage, zone);
+      if (!ssd.blocks(zone).canWrite()) {
+         _state[zone] = ZoneState::Full;
+         _activeZones--;
+         _openZones--;
+      }
+   }
+
+   // zone append, the device picks the offset
+   BPOS append(BID zone, PID logPage) {
+      BPOS offset = writePointer(zone);
+      write(zone, offset, logPage);
+      return offset;
+   }
+
+   // host has to move valid data before, the reset discards the whole zone
+   void reset(BID zone) {
+      ensurem(ssd.blocks(zone).allInvalid(), "reset of zone with valid data");
+      if (_state[zone] == ZoneState::Open || _state[zone] == ZoneState::Closed) {
+         _activeZones--;
+      }
+      if (_state[zone] == ZoneState::Open) {
+         _openZones--;
+      }
+      ssd.eraseBlock(zone);
+      _state[zone] = ZoneState::Empty;
+      _resets++;
+   }
+};
+
+// Host side of a zoned ssd: a log-structured layer that appends pages to open zones
+// and compacts zones (greedy) once it runs out of empty zones.
+// User writes are placed in maxActiveZones - 1 streams, one zone is kept for compaction.
+// A stream follows one application zone (lba range of appZonePages), a new range takes over
+// the least recently used stream. Zone aligned workloads (pattern zns) thus fill device zones exactly.
+// With fewer open than active zones, the host closes the least recently written zone to write another one.
+class ZNSHost {
+   ZonedSSD zns;
+   const uint64_t appZonePages;
+   struct Stream {
+      int64_t zone = -1;
+      int64_t appZone = -1;
+      uint64_t lastUse = 0;
+   };
+   std::vector<Stream> streams;
+   int64_t gcZone = -1;
+   uint64_t gcLastUse = 0;
+   std::list<BID> emptyZones;
+   uint64_t tick = 0;
+   // stats
+   uint64_t _compactionWrites = 0;
+   uint64_t _compactedZones = 0;
+
+ public:
+   ZNSHost(SSD& ssd, uint64_t maxActiveZones, uint64_t appZonePages, uint64_t maxOpenZones = 0)
+       : zns(ssd, maxActiveZones, maxOpenZones), appZonePages(std::max<uint64_t>(1, appZonePages)), streams(maxActiveZones - 1) {
+      ensurem(zns.zoneCount() > maxActiveZones + 1, "not enough zones for the active zone limit");
+      for (BID z = 0; z < zns.zoneCount(); z++) {
+         emptyZones.push_back(z);
+      }
+   }
+
+   std::string name() const {
+      return "zns";
+   }
+
+   uint64_t hostCompactionWrites() const { return _compactionWrites; }
+
+   void writePage(uint64_t pageId, uint8_t handle = 0) { // streams follow lba ranges, handle is ignored
+      Stream& s = streamFor(pageId / appZonePages);
+      if (s.zone == -1) {
+         // keep one empty zone for compaction
+         while (emptyZones.size() <= 1) {
+            compact();
+         }
+         s.zone = openEmptyZone();
+      }
+      reopen(s.zone);
+      zns.append(s.zone, pageId);
+      if (zns.state(s.zone) == ZonedSSD::ZoneState::Full) {
+         s.zone = -1;
+      }
+   }
+
+   void stats() {
+      std::cout << "ZNS stats: compactedZones: " << _compactedZones << " compactionWrites: " << _compactionWrites << " resets: " << zns.resets() << " closes: " << zns.closes() << " emptyZones: " << emptyZones.size() << std::endl;
+      _compactionWrites = 0;
+      _compactedZones = 0;
+   }
+
+   void resetStats() {
+      _compactionWrites = 0;
+      _compactedZones = 0;
+   }
+
+ private:
+   Stream& streamFor(int64_t appZone) {
+      tick++;
+      Stream* lru = &streams[0];
+      for (auto& s: streams) {
+         if (s.appZone == appZone) {
+            s.lastUse = tick;
+            return s;
+         }
+         if (s.lastUse < lru->lastUse) {
+            lru = &s;
+         }
+      }
+      lru->appZone = appZone;
+      lru->lastUse = tick;
+      return *lru;
+   }
+
+   BID openEmptyZone() {
+      ensure(!emptyZones.empty());
+      BID zone = emptyZones.front();
+      emptyZones.pop_front();
+      freeOpenSlot();
+      zns.open(zone);
+      return zone;
+   }
+
+   // open zone limit: closes the least recently written open zone if all open slots are taken
+   void freeOpenSlot() {
+      if (zns.openZones() < zns.maxOpenZones) {
+         return;
+      }
+      int64_t lru = -1;
+      uint64_t lruUse = std::numeric_limits<uint64_t>::max();
+      auto candidate = [&](int64_t zone, uint64_t lastUse) {
+         if (zone != -1 && zns.state(zone) == ZonedSSD::ZoneState::Open && lastUse < lruUse) {
+            lru = zone;
+            lruUse = lastUse;
+         }
+      };
+      for (auto& s: streams) {
+         candidate(s.zone, s.lastUse);
+      }
+      candidate(gcZone, gcLastUse);
+      ensurem(lru != -1, "no open zone to close");
+      zns.close(lru);
+   }
+
+   // a closed zone is opened again before it is written
+   void reopen(BID zone) {
+      if (zns.state(zone) == ZonedSSD::ZoneState::Closed) {
+         freeOpenSlot();
+         zns.open(zone);
+      }
+   }
+
+   // greedy: full zone with the least valid pages
+   BID victimZone() const {
+      int64_t minIdx = -1;
+      uint64_t minCnt = std::numeric_limits<uint64_t>::max();
+      for (BID z = 0; z < zns.zoneCount(); z++) {
+         if (zns.state(z) == ZonedSSD::ZoneState::Full && zns.ssd.blocks(z).validCnt() < minCnt) {
+            minIdx = z;
+            minCnt = zns.ssd.blocks(z).validCnt();
+         }
+      }
+      ensurem(minIdx != -1, "no zone to compact");
+      return minIdx;
+   }
+
+   // moves the valid pages of the victim to the compaction zone and resets the victim
+   void compact() {
+      BID victim = victimZone();
+      const SSD::Block& block = zns.ssd.blocks(victim);
+      ensurem(!block.allValid(), "host compaction can not free a zone");
+      for (BPOS p = 0; p < block.writePos() && !block.allInvalid(); p++) {
+         PID logPage = block.ptl()[p];
+         if (logPage == SSD::unused) {
+            continue;
+         }
+         if (gcZone == -1) {
+            gcZone = openEmptyZone();
+         }
+         reopen(gcZone);
+         gcLastUse = tick;
+         // the device sees a host write, attributed like a gc relocation to the zone of the page
+         zns.ssd.countGCWrite(logPage);
+         zns.append(gcZone, logPage);
+         _compactionWrites++;
+         if (zns.state(gcZone) == ZonedSSD::ZoneState::Full) {
+            gcZone = -1;
+         }
+      }
+      zns.reset(victim);
+      emptyZones.push_back(victim);
+      _compactedZones++;
+   }
+};
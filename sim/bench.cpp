@@ -0,0 +1,238 @@
+// micro benchmarks of the simulator hot paths
+// output: csv lines prefixed with "simbench," (grep them, other output is informational)
+#include "Greedy.hpp"
+#include "Hist.hpp"
+#include "PatternGen.hpp" // RejectionInversionZipf.hpp has no include guard
+#include "SSD.hpp"
+#include "Seed.hpp"
+#include "TwoR.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::string;
+using iob::PatternGen;
+
+struct Geometry {
+   string name;
+   uint64_t capacity;
+   uint64_t erase;
+   uint64_t page = 4096;
+   double fill = 0.875;
+};
+
+struct BenchOptions {
+   string filter;
+   bool quick;
+   uint64_t seed;
+};
+
+static volatile uint64_t sink = 0;
+
+static double nowNs() {
+   return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// pagesPerOp: simulated pages per operation, 0 if the operation does not write pages
+static void report(const string& component, const string& geometry, const string& param, uint64_t ops, double ns, double pagesPerOp) {
+   double nsPerOp = ns / ops;
+   double pagesPerSec = pagesPerOp > 0 ? ops * pagesPerOp / (ns / 1e9) : 0;
+   cout << std::format("simbench,{},{},{},{},{:.2f},{:.0f}", component, geometry, param, ops, nsPerOp, pagesPerSec) << endl;
+}
+
+// random overwrites into free blocks, the ssd is half full so half of the physical space is free
+static void benchSSDWrite(const Geometry& g, const BenchOptions& o) {
+   SSD ssd(g.capacity, g.erase, g.page, 0.5);
+   BID block = 0;
+   for (PID p = 0; p < ssd.logicalPages; p++) {
+      if (!ssd.blocks(block).canWrite()) {
+         block++;
+      }
+      ssd.writePage(p, block);
+   }
+   std::mt19937_64 rng = Seed(o.seed).rng();
+   std::vector<PID> pages(ssd.physicalPages - ssd.logicalPages - ssd.pagesPerBlock);
+   for (auto& p: pages) {
+      p = rng() % ssd.logicalPages;
+   }
+   block++;
+   double start = nowNs();
+   for (PID p: pages) {
+      if (!ssd.blocks(block).canWrite()) {
+         block++;
+      }
+      ssd.writePage(p, block);
+   }
+   report("ssd_write", g.name, "uniform", pages.size(), nowNs() - start, 1);
+}
+
+// host writes through the gc at steady state (uniform), gc cost amortized
+// param tagged: every host write is tagged first, as sim does, so lifetimes are recorded if enabled
+template <typename GC>
+static void benchGCWrites(GC& gc, SSD& ssd, const string& component, const Geometry& g, const BenchOptions& o, const string& param = "uniform") {
+   const bool tag = param != "uniform";
+   std::mt19937_64 rng = Seed(o.seed).split(1).rng();
+   auto write = [&](PID p) {
+      if (tag) {
+         ssd.tagHostWrite(p, 0);
+      }
+      gc.writePage(p);
+   };
+   for (PID p = 0; p < ssd.logicalPages; p++) {
+      write(p);
+   }
+   for (uint64_t i = 0; i < ssd.physicalPages; i++) {
+      write(rng() % ssd.logicalPages);
+   }
+   uint64_t ops = o.quick ? ssd.logicalPages / 4 : ssd.logicalPages;
+   double start = nowNs();
+   for (uint64_t i = 0; i < ops; i++) {
+      write(rng() % ssd.logicalPages);
+   }
+   report(component, g.name, param, ops, nowNs() - start, 1);
+}
+
+static void benchGreedy(const Geometry& g, const BenchOptions& o) {
+   SSD ssd(g.capacity, g.erase, g.page, g.fill);
+   GreedyGC greedy(ssd, 0, false, {}, o.seed);
+   benchGCWrites(greedy, ssd, "greedy_write", g, o);
+   // back to back gcs, every call compacts a different full block
+   uint64_t ops = std::min<uint64_t>(o.quick ? 100 : 1000, ssd.blockCount / 4);
+   uint64_t physBefore = ssd.physWrites();
+   double start = nowNs();
+   for (uint64_t i = 0; i < ops; i++) {
+      greedy.performGC();
+   }
+   double ns = nowNs() - start;
+   report("greedy_gc", g.name, "uniform", ops, ns, (double)(ssd.physWrites() - physBefore) / ops);
+}
+
+// hot path cost of --lifetimes: tagged greedy writes without and with recording
+static void benchLifetimes(const Geometry& g, const BenchOptions& o) {
+   for (bool enabled: {false, true}) {
+      SSD ssd(g.capacity, g.erase, g.page, g.fill);
+      if (enabled) {
+         ssd.enableLifetimes(1);
+      }
+      GreedyGC greedy(ssd, 0, false, {}, o.seed);
+      benchGCWrites(greedy, ssd, "lifetimes_write", g, o, enabled ? "on" : "off");
+   }
+}
+
+// 2r only collects with an empty free list, it is measured through the write path
+static void benchTwoR(const Geometry& g, const BenchOptions& o) {
+   SSD ssd(g.capacity, g.erase, g.page, g.fill);
+   TwoR twoR(ssd, "2r-greedy", o.seed);
+   benchGCWrites(twoR, ssd, "2r_write", g, o);
+}
+
+static void benchZipf(const BenchOptions& o) {
+   std::mt19937_64 rng = Seed(o.seed).rng();
+   uint64_t ops = o.quick ? 1'000'000 : 10'000'000;
+   for (uint64_t n: {1ULL << 20, 1ULL << 30}) {
+      for (double skew: {0.8, 1.2}) {
+         RejectionInversionZipfSampler zipf(n, skew);
+         double start = nowNs();
+         uint64_t sum = 0;
+         for (uint64_t i = 0; i < ops; i++) {
+            sum += zipf.sample(rng);
+         }
+         sink = sum;
+         report("zipf_sample", "n" + std::to_string(n), std::format("s{}", skew), ops, nowNs() - start, 0);
+      }
+   }
+}
+
+static void benchPatterns(const Geometry& g, const BenchOptions& o) {
+   uint64_t ops = o.quick ? 1'000'000 : 10'000'000;
+   std::vector<std::tuple<string, string>> patterns = {
+      {"sequential", ""}, {"uniform", ""}, {"zipf", ""}, {"beta", ""}, {"zones", "s0.9 f0.1 s0.1 f0.9"}, {"seqzones", "4"}};
+   for (auto& [pattern, zones]: patterns) {
+      PatternGen::Options options{};
+      options.patternString = pattern;
+      options.zonesString = zones;
+      options.alpha = 1;
+      options.beta = 5;
+      options.skewFactor = 0.9;
+      options.logicalPages = SSD::logicalPagesFor(g.capacity, g.page, g.fill);
+      options.pageSize = g.page;
+      options.placementString = "none";
+      options.seed = o.seed;
+      PatternGen pg(options);
+      std::mt19937_64 rng = Seed(o.seed).rng();
+      double start = nowNs();
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < ops; i++) {
+         sum += pg.accessPatternGenerator(rng);
+      }
+      sink = sum;
+      report("pattern", g.name, pattern, ops, nowNs() - start, 1);
+   }
+}
+
+static void benchHist(const BenchOptions& o) {
+   uint64_t ops = o.quick ? 10'000'000 : 100'000'000;
+   Hist<int, int> hist(1000, 0, 1000);
+   std::mt19937_64 rng = Seed(o.seed).rng();
+   std::vector<int> values(4096);
+   for (auto& v: values) {
+      v = rng() % 1000;
+   }
+   double start = nowNs();
+   for (uint64_t i = 0; i < ops; i++) {
+      hist.increaseSlot(values[i & 4095]);
+   }
+   sink = hist.cnt;
+   report("hist_increase", "1000slots", "", ops, nowNs() - start, 0);
+}
+
+int main(int argc, char** argv) {
+   CLI::App app{"Simulator micro benchmarks"};
+   BenchOptions o;
+   app.add_option("--filter", o.filter, "Only run components containing this string (ssd, greedy, 2r, lifetimes, zipf, pattern, hist)")->default_val("");
+   app.add_flag("--quick", o.quick, "Smaller geometries and fewer operations")->default_val(false);
+   app.add_option("--seed", o.seed, "Seed of the random streams")->default_val(42);
+   try {
+      app.parse(argc, argv);
+   } catch (const CLI::ParseError& e) {
+      std::exit(app.exit(e));
+   }
+   std::vector<Geometry> geometries = {{"1G-256K", 1ULL << 30, 256 << 10}, {"4G-1M", 4ULL << 30, 1 << 20}, {"16G-8M", 16ULL << 30, 8 << 20}};
+   if (o.quick) {
+      geometries.resize(2);
+   }
+   auto run = [&](const string& name) { return o.filter.empty() || name.contains(o.filter); };
+
+   cout << "simbench,component,geometry,param,ops,nsPerOp,pagesPerSec" << endl;
+   for (auto& g: geometries) {
+      if (run("ssd")) {
+         benchSSDWrite(g, o);
+      }
+      if (run("greedy")) {
+         benchGreedy(g, o);
+      }
+      if (run("2r")) {
+         benchTwoR(g, o);
+      }
+      if (run("lifetimes")) {
+         benchLifetimes(g, o);
+      }
+   }
+   if (run("pattern")) {
+      benchPatterns(geometries[1], o);
+   }
+   if (run("zipf")) {
+      benchZipf(o);
+   }
+   if (run("hist")) {
+      benchHist(o);
+   }
+   return 0;
+}
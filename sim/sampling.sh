@@ -0,0 +1,22 @@
+#!/bin/bash
+# validates spatial sampling against full simulations (rate 1)
+# prints the "sampling" summary lines per pattern
+set -x
+
+cmake -DCMAKE_BUILD_TYPE=Release ..
+make -j sim
+
+CAPACITY=${CAPACITY:-64G}
+ERASE=${ERASE:-8M}
+PAGE=4k
+SSDFILL=0.9
+WRITES=${WRITES:-10}
+GC=${GC:-greedy}
+SAMPLE_RATES=${SAMPLE_RATES:-"0.001 0.01 0.05 0.1 1"}
+
+./sim/sim --capacity=$CAPACITY --erase=$ERASE --page=$PAGE --ssdfill=$SSDFILL --gc=$GC --writes=$WRITES --sample-rates="$SAMPLE_RATES" --prefix=sampling-uni --pattern=uniform > sampling-uni.txt 2>&1 &
+./sim/sim --capacity=$CAPACITY --erase=$ERASE --page=$PAGE --ssdfill=$SSDFILL --gc=$GC --writes=$WRITES --sample-rates="$SAMPLE_RATES" --prefix=sampling-zipf --pattern=zipf --zipf=0.9 > sampling-zipf.txt 2>&1 &
+./sim/sim --capacity=$CAPACITY --erase=$ERASE --page=$PAGE --ssdfill=$SSDFILL --gc=$GC --writes=$WRITES --sample-rates="$SAMPLE_RATES" --prefix=sampling-zones --pattern=zones --zones="s0.9 f0.1 s0.1 f0.9" > sampling-zones.txt 2>&1 &
+wait
+
+grep -h "^sampling" sampling-uni.txt sampling-zipf.txt sampling-zones.txt
@@ -2,14 +2,22 @@
 #include "Greedy.hpp"
 #include "PatternGen.hpp"
 #include "SSD.hpp"
+#include "Sampling.hpp"
+#include "Schedule.hpp"
+#include "Seed.hpp"
 #include "Time.hpp"
 #include "TwoR.hpp"
+#include "ZNS.hpp"
 
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <numeric>
+#include <optional>
 #include <ostream>
 #include <random>
+#include <sstream>
 #include <string>
 
 using std::cout;
@@ -32,28 +40,202 @@ struct SimOptions {
    int writeHeads;
    int optHistSize;
    float printEverySSDWrite;
+   std::string sampleRates;
+   double sampleRate = 1; // of the current run, set by runSampled
+   bool trim;
+   int znsMaxActive;
+   int znsMaxOpen;
+   std::string mapCacheStr;
+   std::string wearLeveling;
+   uint64_t wlThreshold;
+   uint64_t wlInterval;
+   uint64_t waRanges;
+   bool validDist;
+   uint64_t seed; // resolved in main, never 0
+   std::string schedule;
+   bool fitTrace;
+   bool lifetimes;
 };
+
+// sub-streams of the run seed
+enum SeedStream : uint64_t {
+   PatternStream = 1,
+   BenchStream,
+   GCStream,
+   SwitchDistStream,
+   ScheduleStream,
+};
+
+// writes of host-side compaction (zns), 0 for device gc algorithms
+template <typename GCAlgo>
+uint64_t hostCompactionWrites(GCAlgo& gc) {
+   if constexpr (requires { gc.hostCompactionWrites(); }) {
+      return gc.hostCompactionWrites();
+   }
+   return 0;
+}
+
+// compact text encoding of a histogram for a csv column: LEB128 varints, base64
+std::string encodeHistogram(const std::vector<uint64_t>& hist) {
+   std::string bytes;
+   for (uint64_t v: hist) {
+      do {
+         uint8_t b = v & 0x7f;
+         v >>= 7;
+         bytes.push_back(v ? (b | 0x80) : b);
+      } while (v);
+   }
+   static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+   std::string out;
+   for (size_t i = 0; i < bytes.size(); i += 3) {
+      uint32_t n = (uint8_t)bytes[i] << 16;
+      n |= i + 1 < bytes.size() ? (uint8_t)bytes[i + 1] << 8 : 0;
+      n |= i + 2 < bytes.size() ? (uint8_t)bytes[i + 2] : 0;
+      out.push_back(alphabet[(n >> 18) & 63]);
+      out.push_back(alphabet[(n >> 12) & 63]);
+      out.push_back(i + 1 < bytes.size() ? alphabet[(n >> 6) & 63] : '=');
+      out.push_back(i + 2 < bytes.size() ? alphabet[n & 63] : '=');
+   }
+   return out;
+}
+
+// page lifetimes in host writes (dead: overwritten, alive: age of pages not overwritten yet)
+// csv rows per log-linear bin [lower, upper), zone -1 is all zones
+void writeLifetimes(const Lifetimes& lt, const std::string& logHash, const std::string& prefix) {
+   std::ofstream file("sim_lifetimes_" + logHash + "_" + prefix + ".csv");
+   file << "sim,hash,prefix,kind,zone,lower,upper,count" << endl;
+   auto write = [&](const string& kind, int64_t zone, const uint64_t* hist) {
+      for (uint64_t b = 0; b < Lifetimes::bins; b++) {
+         if (hist[b] > 0) {
+            file << std::format("lifetime,{},'{}',{},{},{},{},{}\n", logHash, prefix, kind, zone, Lifetimes::binLower(b), Lifetimes::binUpper(b), hist[b]);
+         }
+      }
+   };
+   write("dead", -1, lt.hist());
+   for (uint64_t z = 0; z < lt.zones(); z++) {
+      write("dead", z, lt.hist(z));
+   }
+   write("alive", -1, lt.aliveAges().data());
+   for (int64_t z = -1; z < (int64_t)lt.zones(); z++) {
+      cout << std::format("lifetimes zone {}: overwrites: {} p10: {} p50: {} p90: {} p99: {}", z, lt.count(z), lt.quantile(0.1, z), lt.quantile(0.5, z), lt.quantile(0.9, z), lt.quantile(0.99, z)) << endl;
+   }
+}
+
+// returns the cumulative WAF, sampler maps the trace pages to the scaled down ssd (nullptr: pattern pages are ssd pages)
 template <typename GCAlgo>
-void runBench(GCAlgo& gc, SSD& ssd, PatternGen::Options& pgOptions, SimOptions& options) {
-   std::random_device randDevice;
-   std::mt19937_64 rng{randDevice()};
+float runBench(GCAlgo& gc, SSD& ssd, PatternGen::Options& pgOptions, SimOptions& options, SpatialSampler* sampler = nullptr) {
+   std::mt19937_64 rng = Seed(options.seed).split(BenchStream).rng();
    // cout << "writesPerRep: " << (float)((writesPerRep * pageSize) / (float)gb) << " GB" << endl;
-   std::unique_ptr<PatternGen> pg = std::make_unique<PatternGen>(pgOptions);
+   // either a single pattern or a schedule of phases
+   std::unique_ptr<PatternGen> pg;
+   std::unique_ptr<WorkloadSchedule> schedule;
+   std::vector<PatternGen*> generators;
+   if (options.schedule.empty()) {
+      pg = std::make_unique<PatternGen>(pgOptions);
+      generators.push_back(pg.get());
+   } else {
+      schedule = std::make_unique<WorkloadSchedule>(options.schedule, pgOptions, Seed(options.seed).split(ScheduleStream).value);
+      WorkloadSchedule::checkRangesPlacement(options.schedule, pgOptions);
+      for (auto& phase: schedule->phases()) {
+         generators.push_back(phase.pg.get());
+      }
+   }
+   uint64_t placementHandles = 0;
+   uint64_t zoneCount = 0;
+   for (PatternGen* gen: generators) {
+      gen->emitDiscards = options.trim;
+      placementHandles = std::max(placementHandles, gen->placementHandles);
+      zoneCount = std::max(zoneCount, gen->zoneCount());
+   }
+   auto activePattern = [&]() -> PatternGen& { return schedule ? schedule->pg() : *pg; };
+   ssd.enablePlacementHandles(placementHandles);
+   ssd.enableZoneAttribution(options.waRanges > 0 ? options.waRanges : zoneCount);
+   if (options.lifetimes) {
+      ssd.enableLifetimes(options.waRanges > 0 ? options.waRanges : zoneCount);
+   }
+   // the cache is scaled down with the ssd when sampling
+   ssd.enableMappingCache(getBytesFromString(options.mapCacheStr) * options.sampleRate);
+   // next page of the pattern that is part of the simulated ssd, -1 if skipped by the sampler
+   // discards of the pattern are applied before the write, handle is the placement handle of the write
+   // zone is the access zone of the write or its lba range (--wa-ranges)
+   uint8_t handle = 0;
+   int zone = 0;
+   auto nextPage = [&]() -> int64_t {
+      PatternGen& active = activePattern();
+      uint64_t logPage = schedule ? schedule->access(rng, handle, &zone) : pg->accessPatternGenerator(rng, handle, &zone);
+      bool rotated = schedule && schedule->rotating();
+      for (auto [first, count]: active.discards) {
+         if (!sampler && !rotated) {
+            ssd.trimRange(first, count);
+            continue;
+         }
+         for (uint64_t p = first; p < first + count; p++) {
+            int64_t trimmed = rotated ? schedule->rotate(p) : p;
+            trimmed = sampler ? sampler->map(trimmed) : trimmed;
+            if (trimmed >= 0) {
+               ssd.trimPage(trimmed);
+            }
+         }
+      }
+      active.discards.clear();
+      int64_t page = sampler ? sampler->map(logPage) : logPage;
+      if (options.waRanges > 0 && page >= 0) {
+         zone = (u128)page * options.waRanges / ssd.logicalPages;
+      }
+      return page;
+   };
+
+   // zone (or lba range) that owns each page of the ssd, for the initial fill
+   std::vector<uint16_t> initZones;
+   if (ssd.zoneAttribution().enabled() && options.waRanges == 0) {
+      std::vector<uint16_t> owners = generators[0]->pageZones();
+      if (sampler) {
+         initZones.assign(ssd.logicalPages, 0);
+         for (uint64_t p = 0; p < owners.size(); p++) {
+            int64_t page = sampler->map(p);
+            if (page >= 0 && (uint64_t)page < initZones.size()) {
+               initZones[page] = owners[p];
+            }
+         }
+      } else {
+         initZones = std::move(owners);
+      }
+   }
+   auto initZone = [&](uint64_t page) -> uint16_t {
+      if (options.waRanges > 0) {
+         return (u128)page * options.waRanges / ssd.logicalPages;
+      }
+      return page < initZones.size() ? initZones[page] : 0;
+   };
 
    // seq init, guarantees ssd is full,
+   // tagged like host writes: stamps the lifetimes and attributes gc writes of never rewritten pages to their zone
    for (uint64_t i = 0; i < ssd.logicalPages; i++) {
+      ssd.tagHostWrite(i, 0, initZone(i));
       gc.writePage(i);
    }
    if (options.initLoad) {
       // a batch of writes based on access pattern to fill OP
       // uint64_t writeOP = ssd.physicalPages - ssd.logicalPages;
       uint64_t writeOP = ssd.physicalPages;
-      for (uint64_t i = 0; i < writeOP; i++) {
-         uint64_t logPage = pg->accessPatternGenerator(rng);
-         gc.writePage(logPage);
+      for (uint64_t i = 0; i < writeOP;) {
+         int64_t logPage = nextPage();
+         if (logPage < 0) {
+            continue;
+         }
+         ssd.tagHostWrite(logPage, handle, zone);
+         gc.writePage(logPage, handle);
+         i++;
       }
       cout << "Init WA: " << std::to_string(((float)ssd.physWrites()) / ssd.logicalPages) << endl;
    }
+   if (schedule) {
+      schedule->restart();
+   }
+   // lifetimes of the run only, the last writes of the load are kept
+   if (ssd.lifetimes()) {
+      ssd.lifetimes()->resetHistograms();
+   }
    ssd.resetPhysicalCounters();
    gc.resetStats();
 
@@ -63,59 +245,220 @@ void runBench(GCAlgo& gc, SSD& ssd, PatternGen::Options& pgOptions, SimOptions&
    std::ofstream logFile(filename, std::ios::app);
    if (!logFile.is_open()) {
       std::cerr << "Error opening runBench log file." << std::endl;
-      return;
+      return 0;
    }
 
    std::string header = "sim,hash,prefix,ssdwrites,rep,time,capacity,erase,pagesize,pattern,skew,zones,alpha,beta,ssdFill,gc,";
    header += "mdcbatch,writeheads,timestamps,opthistsize,";
-   header += "freePercentaftergc,runningWAF,cumulativeWAF";
+   header += "freePercentaftergc,runningWAF,cumulativeWAF,samplerate,trimmed,hostWAF,deviceWAF,";
+   header += "mapcache,mapreads,mapwrites,maphitrate,mapWAF,";
+   header += "wlWAF,erasemin,erasep50,erasep99,erasemax,validdist,seed,phase";
    cout << header << endl;
    if (!fileExists) {
       logFile << header << endl;
    }
 
+   // per handle and per zone/range breakdown, gc writes are attributed to the class that last wrote the page
+   // waf of a class: (host + gc writes) / host writes of the class, share: its part of all host writes
+   std::ofstream breakdownFile;
+   if (ssd.handleAttribution().enabled() || ssd.zoneAttribution().enabled()) {
+      std::string breakdownFilename = "sim_breakdown_" + logHash + "_" + options.prefix + ".csv";
+      breakdownFile.open(breakdownFilename);
+      breakdownFile << "sim,hash,prefix,rep,kind,id,hostwrites,gcwrites,waf,share" << endl;
+   }
+   auto writeBreakdown = [&](uint64_t rep, const string& kind, const WriteAttribution& attribution) {
+      uint64_t allHost = std::accumulate(attribution.hostWrites().begin(), attribution.hostWrites().end(), 0ULL);
+      for (uint64_t c = 0; c < attribution.classes(); c++) {
+         uint64_t host = attribution.hostWrites()[c];
+         uint64_t gcWrites = attribution.gcWrites()[c];
+         breakdownFile << std::format("breakdown,{},'{}',{},{},{},{},{},{:.5f},{:.5f}\n", logHash, options.prefix, rep, kind, c, host, gcWrites,
+            host ? (float)(host + gcWrites) / host : 0.0f, allHost ? (float)host / allHost : 0.0f);
+      }
+   };
+   // tenants of a mix: totals over all reps
+   bool tenants = options.waRanges == 0 && !schedule && pg->pattern == PatternGen::Pattern::Mix;
+   std::vector<uint64_t> tenantHost(tenants ? ssd.zoneAttribution().classes() : 0);
+   std::vector<uint64_t> tenantGC(tenantHost.size());
+
    // bench
    uint64_t writesPerRep = ssd.logicalPages / options.printEverySSDWrite;
-   uint64_t numReps = pg->options.totalWrites / writesPerRep;
+   double totalWrites = schedule ? schedule->totalWrites() : pg->options.writesInDiskOverwrites;
+   uint64_t numReps = (totalWrites * ssd.logicalPages) / writesPerRep;
    uint64_t cumulativePhysWrites = 0; // Cumulative physical writes across all repetitions
    uint64_t cumulativeLogWrites = 0;  // Cumulative logical writes across all repetitions
+   float cumulativeWAF = 0;
    auto start = mean::getSeconds();
    for (uint64_t rep = 0; rep < numReps; rep++) {
-      if (options.switchDist && rep == numReps/2) {
-         pg = std::make_unique<PatternGen>(pgOptions);
+      if (options.switchDist && !schedule && rep == numReps/2) {
+         // new distribution, i.e. a different shuffle
+         PatternGen::Options switched = pgOptions;
+         switched.seed = Seed(options.seed).split(SwitchDistStream).value;
+         pg = std::make_unique<PatternGen>(switched);
+         pg->emitDiscards = options.trim;
       }
 
-      for (uint64_t i = 0; i < writesPerRep; i++) {
-         uint64_t logPage = pg->accessPatternGenerator(rng);
-         gc.writePage(logPage);
+      for (uint64_t i = 0; i < writesPerRep;) {
+         int64_t logPage = nextPage();
+         if (logPage < 0) {
+            continue;
+         }
+         ssd.tagHostWrite(logPage, handle, zone);
+         gc.writePage(logPage, handle);
          cumulativeLogWrites++;
+         i++;
       }
 
-      cumulativePhysWrites += ssd.physWrites();
-      float currentWAF = ((float)ssd.physWrites()) / writesPerRep;
-      float cumulativeWAF = (float)cumulativePhysWrites / (float)cumulativeLogWrites;
+      // data pages only: translation page writes of the mapping cache take no flash space and cause no gc, see mapWAF
+      uint64_t flashWrites = ssd.physWrites();
+      cumulativePhysWrites += flashWrites;
+      float currentWAF = ((float)flashWrites) / writesPerRep;
+      // runningWAF = hostWAF * deviceWAF, host compaction writes are issued to the device like user writes
+      uint64_t deviceHostWrites = writesPerRep + hostCompactionWrites(gc);
+      float hostWAF = (float)deviceHostWrites / writesPerRep;
+      float deviceWAF = (float)flashWrites / deviceHostWrites;
+      cumulativeWAF = (float)cumulativePhysWrites / (float)cumulativeLogWrites;
       auto now = mean::getSeconds();
       auto s = std::format("bench,{},'{}',{},{},{:.2f},{},{},{},{},{},'{}',{},{},{:.4f},",
          logHash, options.prefix, (float)rep*1/options.printEverySSDWrite, rep, now - start, ssd.capacityBytes, ssd.blockSizeBytes, ssd.pageSizeBytes,
-         pg->options.patternString, pg->options.skewFactor, pg->patternDetails(),
-         pg->options.alpha, pg->options.beta, ssd.ssdFill);
+         activePattern().options.patternString, activePattern().options.skewFactor, activePattern().patternDetails(),
+         activePattern().options.alpha, activePattern().options.beta, ssd.ssdFill);
       s += std::format("{},{},{},{},{},",
          gc.name(),
          options.mdcBatch, options.writeHeads, options.timestamps, options.optHistSize);
-      s += std::format("{:.4f},{:.5f},{:.5f}\n",
-         writesPerRep / (float)ssd.physWrites(), currentWAF, cumulativeWAF);
+      s += std::format("{:.4f},{:.5f},{:.5f},{},{},{:.5f},{:.5f},",
+         writesPerRep / (float)ssd.physWrites(), currentWAF, cumulativeWAF, options.sampleRate, ssd.trimmedPages(),
+         hostWAF, deviceWAF);
+      // map reads per host write are the extra flash reads on the write path (latency)
+      // mapWAF: translation page writes per host write, runningWAF + mapWAF is a lower bound of the flash writes
+      const MappingCache* mc = ssd.mapCache();
+      const uint64_t lookups = mc ? mc->hits() + mc->misses() : 0;
+      s += std::format("{},{},{},{:.5f},{:.5f},",
+         mc ? mc->cacheSlots * ssd.pageSizeBytes : 0, ssd.mapReads(), ssd.mapWrites(),
+         lookups ? (float)mc->hits() / lookups : 1.0f, (float)ssd.mapWrites() / writesPerRep);
+      // wear leveling writes are part of runningWAF, wlWAF is their share
+      // validdist: fully written blocks per valid count [0, pagesPerBlock], see encodeHistogram
+      s += std::format("{:.5f},{},{},{},{},{},{},{}\n",
+         (float)ssd.wlWrites() / writesPerRep, ssd.eraseMin(), ssd.eraseCountPercentile(0.5), ssd.eraseCountPercentile(0.99), ssd.eraseMax(),
+         options.validDist ? encodeHistogram(ssd.validCountHist()) : "", options.seed, schedule ? schedule->phase() : 0);
       cout << s << std::flush;
       logFile << s << std::flush;
+      if (breakdownFile.is_open()) {
+         writeBreakdown(rep, "handle", ssd.handleAttribution());
+         writeBreakdown(rep, options.waRanges > 0 ? "range" : (tenants ? "tenant" : "zone"), ssd.zoneAttribution());
+         breakdownFile << std::flush;
+      }
+      for (uint64_t t = 0; t < tenantHost.size(); t++) {
+         tenantHost[t] += ssd.zoneAttribution().hostWrites()[t];
+         tenantGC[t] += ssd.zoneAttribution().gcWrites()[t];
+      }
       ssd.resetPhysicalCounters();
       // ssd.printBlocksStats();
       gc.stats();
    }
    // ssd.printBlocksStats();
+   uint64_t allTenantHost = std::accumulate(tenantHost.begin(), tenantHost.end(), 0ULL);
+   for (uint64_t t = 0; t < tenantHost.size(); t++) {
+      const auto& tenant = pg->accessZones[t];
+      cout << std::format("tenant {}: pages: {} rate: {} writeshare: {:.4f} WAF: {:.4f}", t, tenant.count, tenant.freq,
+         allTenantHost ? (float)tenantHost[t] / allTenantHost : 0.0f, tenantHost[t] ? (float)(tenantHost[t] + tenantGC[t]) / tenantHost[t] : 0.0f) << endl;
+   }
 
    logFile.close();
+   if (ssd.lifetimes()) {
+      writeLifetimes(*ssd.lifetimes(), logHash, options.prefix);
+   }
 
    // pg.generateAccessFrequencyHistogram(ssd.writtenPages, ssd.ssdFill);
    //  Save the access pattern data to file and generate the plot
+   return cumulativeWAF;
+}
+
+float runGC(SSD& ssd, PatternGen::Options& pgOptions, SimOptions& options, SpatialSampler* sampler = nullptr) {
+   WearLeveling wl = WearLeveling::parse(options.wearLeveling, options.wlThreshold, options.wlInterval);
+   ensurem(!wl.enabled() || options.gcAlgorithm.starts_with("greedy"), "wear leveling is only implemented for the greedy gc");
+   // 2r, greedy-s2r and zns have a single write stream, they would silently ignore the handles
+   ensurem(pgOptions.placementString == "none" || options.gcAlgorithm == "greedy" || options.gcAlgorithm.starts_with("greedy-k"),
+           "--placement is only implemented for the greedy gc (greedy, greedy-kN)");
+   uint64_t gcSeed = Seed(options.seed).split(GCStream).value;
+   if (options.gcAlgorithm == "greedy") {
+      GreedyGC greedy(ssd, 0, false, wl, gcSeed);
+      return runBench(greedy, ssd, pgOptions, options, sampler);
+   } else if (options.gcAlgorithm.contains("greedy-k")) {
+      int k = std::stoi(options.gcAlgorithm.substr(8));
+      GreedyGC greedy(ssd, k, false, wl, gcSeed);
+      return runBench(greedy, ssd, pgOptions, options, sampler);
+   } else if (options.gcAlgorithm.contains("greedy-s2r")) {
+      GreedyGC greedy(ssd, 0, true, wl, gcSeed);
+      return runBench(greedy, ssd, pgOptions, options, sampler);
+   } else if (options.gcAlgorithm.contains("2r")) {
+      TwoR twoR(ssd, options.gcAlgorithm, gcSeed);
+      return runBench(twoR, ssd, pgOptions, options, sampler);
+   } else if (options.gcAlgorithm == "zns") {
+      // ssd blocks are the zones, host streams follow the zones of the zns pattern
+      uint64_t appZonePages = pgOptions.patternString.contains("zns") ? pgOptions.znsPagesPerZone : ssd.pagesPerBlock;
+      ZNSHost zns(ssd, options.znsMaxActive, appZonePages, options.znsMaxOpen);
+      return runBench(zns, ssd, pgOptions, options, sampler);
+   } else if (options.gcAlgorithm.contains("deathtime")) {
+      // DTE edt(ssd, gcAlgorithm);
+      // runBench(edt, ssd, pg, targetWrites, initLoad);
+      return 0;
+   } else {
+      throw std::runtime_error("unknown gc algorithm: " + options.gcAlgorithm);
+   }
+}
+
+// simulates a scaled down ssd for every sample rate, the spread between the rates is an estimate of the sampling error.
+// synthetic patterns are generated on the scaled down page space, trace pages are sampled by their hash
+void runSampled(uint64_t capacity, uint64_t blockSize, uint64_t pageSize, PatternGen::Options& pgOptions, SimOptions& options) {
+   std::vector<double> rates;
+   std::stringstream ss(options.sampleRates);
+   for (std::string token; ss >> token;) {
+      rates.push_back(std::stod(token));
+   }
+   ensurem(!rates.empty(), "no sample rate given");
+   std::ranges::sort(rates);
+   const bool traces = PatternGen::readsTraces(pgOptions) || options.schedule.contains("trace");
+   std::vector<std::tuple<double, uint64_t, uint64_t, float>> results; // rate, pages, blocks, waf
+   for (double rate: rates) {
+      ensurem(rate > 0 && rate <= 1, "sample rate must be in (0, 1]");
+      options.sampleRate = rate;
+      std::optional<SpatialSampler> sampler;
+      uint64_t pages = std::max<uint64_t>(1, std::llround(pgOptions.logicalPages * rate));
+      if (traces) {
+         sampler.emplace(rate, pgOptions.logicalPages);
+         pages = sampler->maxPages;
+      }
+      SSD ssd(SpatialSampler::scaledCapacity(pages, blockSize, pageSize, options.ssdFill), blockSize, pageSize, options.ssdFill);
+      cout << "sample rate: " << rate << " scaled pages: " << pages << (traces ? " (hash sampled trace)" : "") << endl;
+      ssd.printInfo();
+      if (ssd.blockCount < 64) {
+         cout << "warning: only " << ssd.blockCount << " blocks at sample rate " << rate << ", expect a large error" << endl;
+      }
+      float waf;
+      if (sampler) {
+         waf = runGC(ssd, pgOptions, options, &*sampler);
+         pages = sampler->sampledPages();
+      } else {
+         PatternGen::Options scaled = pgOptions;
+         PatternGen::cliOptionsParsed(scaled, ssd.logicalPages, pageSize);
+         waf = runGC(ssd, scaled, options);
+         pages = ssd.logicalPages;
+      }
+      results.emplace_back(rate, pages, ssd.blockCount, waf);
+   }
+   // the highest rate is the reference (1 is a full simulation)
+   float reference = std::get<3>(results.back());
+   float minWaf = std::numeric_limits<float>::max();
+   float maxWaf = 0;
+   cout << "sampling,rate,pages,blocks,cumulativeWAF,diffToRate" << std::get<0>(results.back()) << ",relErr" << endl;
+   for (auto& [rate, pages, blocks, waf]: results) {
+      minWaf = std::min(minWaf, waf);
+      maxWaf = std::max(maxWaf, waf);
+      cout << std::format("sampling,{},{},{},{:.5f},{:.5f},{:.4f}", rate, pages, blocks, waf, waf - reference, (waf - reference) / reference) << endl;
+   }
+   cout << std::format("sampling summary: capacity: {} pattern: {} gc: {} waf: {:.4f} spread: [{:.4f}, {:.4f}] (+-{:.2f}%)",
+                       capacity, pgOptions.patternString, options.gcAlgorithm, reference, minWaf, maxWaf, (maxWaf - minWaf) / 2 / reference * 100)
+        << endl;
 }
 
 // NOLINTBEGIN(bugprone-exception-escape)
@@ -130,7 +473,7 @@ int main(int argc, char** argv) {
    app.add_option("--prefix", options.prefix, "Prefix for output/log files")->envname("PREFIX")->default_val("output");
    app.add_option("--ssdfill", options.ssdFill, "SSD fill ratio (0 <= fill <= 1)")->envname("SSDFILL")->check(CLI::Range(0.0F, 1.0F))->default_val("0.875");
    app.add_option("--load", options.initLoad, "Initial load")->envname("LOAD")->default_val(true);
-   app.add_option("--gc", options.gcAlgorithm, "GC algorithm")->envname("GC")->default_val("greedy");
+   app.add_option("--gc", options.gcAlgorithm, "GC algorithm (zns: zoned device with host compaction, --erase is the zone size)")->envname("GC")->default_val("greedy");
    app.add_flag("--switch-dist", options.switchDist, "resets the distribution after half the writes")->envname("SWITCH_DIST")->default_val(false);
    app.add_option("--print-every", options.printEverySSDWrite, "Print every 1/nth SSD writes")->envname("PRINT_EVERY_SSD_WRITE")->default_val(10);
    // gc options
@@ -141,6 +484,25 @@ int main(int argc, char** argv) {
    app.add_option("--write-heads", options.writeHeads, "Number of write heads")->envname("WRITE_HEADS")->default_val(20);
    // opt
    app.add_option("--opt-hist-size", options.optHistSize, "Optimal GC history size")->envname("OPT_HIST_SIZE")->default_val(1000);
+   app.add_flag("--trim", options.trim, "Apply discards of the pattern (zns zone resets, trace discards) as TRIM. Trace discards: blktrace D records and the D op column of Alibaba/MSR/FIU writetrace files, the extracted Alibaba/MSR/FIU traces have none")->envname("TRIM")->default_val(false);
+   // zns
+   app.add_option("--zns-max-active", options.znsMaxActive, "Active zone limit of the zoned device")->envname("ZNS_MAX_ACTIVE")->default_val(14);
+   app.add_option("--zns-max-open", options.znsMaxOpen, "Open zone limit of the zoned device, 0: same as the active zone limit")->envname("ZNS_MAX_OPEN")->default_val(0);
+   // wear leveling
+   app.add_option("--wear-leveling", options.wearLeveling, "Wear leveling of the greedy gc: none, dynamic, static, both")->envname("WEAR_LEVELING")->default_val("none");
+   app.add_option("--wl-threshold", options.wlThreshold, "Erase count spread (max - min) that triggers static wear leveling")->envname("WL_THRESHOLD")->default_val(20);
+   app.add_option("--wl-interval", options.wlInterval, "Erases between two checks of the static wear leveling, a check scans all blocks")->envname("WL_INTERVAL")->default_val(8);
+   app.add_option("--wa-ranges", options.waRanges, "Attribute host and gc writes to N equal lba ranges instead of the pattern zones (sim_breakdown csv)")->envname("WA_RANGES")->default_val(0);
+   app.add_flag("--lifetimes", options.lifetimes, "Record page lifetimes in host writes, overall and per zone (sim_lifetimes csv)")->envname("LIFETIMES")->default_val(false);
+   app.add_flag("--valid-dist", options.validDist, "Export the valid count distribution of the blocks per rep (csv column validdist, base64 varints)")->envname("VALID_DIST")->default_val(false);
+   // dram-less
+   app.add_option("--map-cache", options.mapCacheStr, "Mapping table cache size (e.g. 64M), translation pages are read/written on miss/eviction (0: full table in dram)")->envname("MAP_CACHE")->default_val("0");
+   // sampling
+   app.add_option("--sample-rates", options.sampleRates, "Spatial sample rates, e.g. \"0.01 0.05 1\", simulates a scaled down ssd per rate, synthetic patterns are generated on the scaled page space, trace pages are hash sampled (empty: full ssd)")->envname("SAMPLE_RATES")->default_val("");
+
+   app.add_flag("--fit-trace", options.fitTrace, "Sets the capacity to the address range of the trace (after --trace-remap) at --ssdfill")->envname("FIT_TRACE")->default_val(false);
+   app.add_option("--schedule", options.schedule, "Workload phases, e.g. \"pattern=zipf,zipf=0.9,writes=2;pattern=uniform,writes=3,drift=0.5\" (fields: pattern, zones, zipf, alpha, beta, writes, drift), replaces --pattern and --writes")->envname("SCHEDULE")->default_val("");
+   app.add_option("--seed", options.seed, "Seed of all random streams, the same seed reproduces a run (0: random, printed and written to the csv)")->envname("SEED")->default_val(0);
 
    std::unique_ptr<iob::PatternGen::Options> pgOptions = iob::PatternGen::setupCliOptions(app);
 
@@ -153,33 +515,34 @@ int main(int argc, char** argv) {
    uint64_t pageSize = getBytesFromString(options.pageStr);
    uint64_t capacity = getBytesFromString(options.capacityStr);
    uint64_t blockSize = getBytesFromString(options.eraseStr);
-   SSD ssd(capacity, blockSize, pageSize, options.ssdFill);
-   ssd.printInfo();
 
-   iob::PatternGen::cliOptionsParsed(*pgOptions, ssd.logicalPages, ssd.pageSizeBytes);
+   options.seed = Seed(options.seed).value;
+   cout << "seed: " << options.seed << endl;
+   pgOptions->seed = Seed(options.seed).split(PatternStream).value;
+   iob::PatternGen::cliOptionsParsed(*pgOptions, SSD::logicalPagesFor(capacity, pageSize, options.ssdFill), pageSize);
+   if (options.fitTrace) {
+      // smallest capacity (whole blocks) whose logical pages hold the address range of the trace
+      ensurem(iob::PatternGen::stringToPattern(pgOptions->patternString) == iob::PatternGen::Pattern::Traces, "--fit-trace needs a trace pattern");
+      uint64_t range = iob::PatternGen::traceAddressRange(*pgOptions);
+      capacity = std::ceil(range / options.ssdFill) * pageSize;
+      capacity = (capacity + blockSize - 1) / blockSize * blockSize;
+      while (SSD::logicalPagesFor(capacity, pageSize, options.ssdFill) < range) {
+         capacity += blockSize;
+      }
+      cout << "fit trace: " << range << " pages, capacity: " << capacity << endl;
+      iob::PatternGen::cliOptionsParsed(*pgOptions, SSD::logicalPagesFor(capacity, pageSize, options.ssdFill), pageSize);
+   }
    iob::PatternGen::printPatternHistorgram(*pgOptions);
    // Pattern generation options
 
    cout << "switch: " << options.switchDist << " load: " << options.initLoad << endl;
 
-   if (options.gcAlgorithm == "greedy") {
-      GreedyGC greedy(ssd);
-      runBench(greedy, ssd, *pgOptions, options);
-   } else if (options.gcAlgorithm.contains("greedy-k")) {
-      int k = std::stoi(options.gcAlgorithm.substr(8));
-      GreedyGC greedy(ssd, k);
-      runBench(greedy, ssd, *pgOptions, options);
-   } else if (options.gcAlgorithm.contains("greedy-s2r")) {
-      GreedyGC greedy(ssd, 0, true);
-      runBench(greedy, ssd, *pgOptions, options);
-   } else if (options.gcAlgorithm.contains("2r")) {
-      TwoR twoR(ssd, options.gcAlgorithm);
-      runBench(twoR, ssd, *pgOptions, options);
-   } else if (options.gcAlgorithm.contains("deathtime")) {
-      // DTE edt(ssd, gcAlgorithm);
-      // runBench(edt, ssd, pg, targetWrites, initLoad);
+   if (!options.sampleRates.empty()) {
+      runSampled(capacity, blockSize, pageSize, *pgOptions, options);
    } else {
-      throw std::runtime_error("unknown gc algorithm: " + options.gcAlgorithm);
+      SSD ssd(capacity, blockSize, pageSize, options.ssdFill);
+      ssd.printInfo();
+      runGC(ssd, *pgOptions, options);
    }
    return 0;
 }
@@ -0,0 +1,129 @@
+// converts the binary per-I/O trace of iob (--iotrace, iob-trace-<prefix>.bin)
+//   --csv:     one line per I/O: thread,reqid,type,begin,end,latency,addr,len (times in ns since the start of the run)
+//   --columns: one raw little endian file per column in a directory (thread.u32, reqid.u16, type.u8, begin.u64,
+//              end.u64, addr.u64, len.u32), e.g. numpy.fromfile(dir + "/begin.u64", dtype="<u8") or readBin in R
+// type: 1 write, 2 read, 3 fsync (IoRequestType)
+#include "Exceptions.hpp"
+#include "IoTraceFormat.hpp"
+
+#include <CLI/CLI.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::string;
+
+struct ConvertOptions {
+    string file;
+    string csv;
+    string columns;
+};
+
+// buffered column file
+class Column {
+    std::ofstream out;
+    std::vector<char> buffer;
+
+public:
+    explicit Column(const string& path) : out(path, std::ios::binary | std::ios::trunc) {
+        ensurem(out.good(), "could not open " + path);
+        buffer.reserve(1 << 20);
+    }
+    ~Column() { flush(); }
+    template <typename T>
+    void add(T v) {
+        const char* p = (const char*)&v;
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+        if (buffer.size() >= (1 << 20)) {
+            flush();
+        }
+    }
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+};
+
+int main(int argc, char** argv) {
+    CLI::App app{"Convert an iob I/O trace"};
+    ConvertOptions o;
+    app.add_option("--file", o.file, "iob-trace-<prefix>.bin")->required();
+    app.add_option("--csv", o.csv, "CSV output, - for stdout")->default_val("");
+    app.add_option("--columns", o.columns, "Directory for the columnar output")->default_val("");
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError& e) {
+        std::exit(app.exit(e));
+    }
+    ensurem(!o.csv.empty() || !o.columns.empty(), "nothing to do, use --csv and/or --columns");
+
+    std::ifstream in(o.file, std::ios::binary);
+    ensurem(in.good(), "could not open " + o.file);
+    iobtrace::Reader reader(in);
+    ensurem(reader.open(), o.file + " is not an iob trace (or a different version)");
+    const double tscPerNs = reader.file.tscPerNs;
+    const uint64_t start = reader.file.startTsc;
+    auto ns = [&](uint64_t tsc) { return (int64_t)((int64_t)(tsc - start) / tscPerNs); };
+
+    std::ofstream csvFile;
+    std::ostream* csv = nullptr;
+    if (o.csv == "-") {
+        csv = &cout;
+    } else if (!o.csv.empty()) {
+        csvFile.open(o.csv, std::ios::trunc);
+        ensurem(csvFile.good(), "could not open " + o.csv);
+        csv = &csvFile;
+    }
+    if (csv) {
+        *csv << "thread,reqid,type,begin,end,latency,addr,len\n";
+    }
+    std::vector<std::unique_ptr<Column>> columns;
+    if (!o.columns.empty()) {
+        std::filesystem::create_directories(o.columns);
+        for (const char* name: {"thread.u32", "reqid.u16", "type.u8", "begin.u64", "end.u64", "addr.u64", "len.u32"}) {
+            columns.push_back(std::make_unique<Column>(o.columns + "/" + name));
+        }
+    }
+
+    iobtrace::ChunkHeader chunk;
+    std::vector<iobtrace::Record> records;
+    uint64_t chunks = 0;
+    uint64_t ios = 0;
+    uint64_t dropped = 0;
+    string line;
+    while (reader.next(chunk, records)) {
+        chunks++;
+        ios += records.size();
+        dropped += chunk.dropped;
+        for (const auto& r: records) {
+            const int64_t begin = ns(r.begin);
+            const int64_t end = ns(r.end);
+            if (csv) {
+                line.clear();
+                line += std::to_string(chunk.thread) + "," + std::to_string(r.reqId) + "," + std::to_string(r.type) + ",";
+                line += std::to_string(begin) + "," + std::to_string(end) + "," + std::to_string(end - begin) + ",";
+                line += std::to_string(r.addr) + "," + std::to_string(r.len) + "\n";
+                *csv << line;
+            }
+            if (!columns.empty()) {
+                columns[0]->add<uint32_t>(chunk.thread);
+                columns[1]->add<uint16_t>(r.reqId);
+                columns[2]->add<uint8_t>(r.type);
+                columns[3]->add<uint64_t>(begin);
+                columns[4]->add<uint64_t>(end);
+                columns[5]->add<uint64_t>(r.addr);
+                columns[6]->add<uint32_t>(r.len);
+            }
+        }
+    }
+    std::cerr << "iobtrace: " << ios << " I/Os in " << chunks << " chunks, bs: " << reader.file.bs << ", tsc/ns: " << tscPerNs;
+    std::cerr << (dropped ? ", dropped while recording: " + std::to_string(dropped) : "") << endl;
+    return 0;
+}
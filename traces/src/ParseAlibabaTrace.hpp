@@ -12,6 +12,10 @@
 #include <numeric>
 #include <filesystem>
 
+#include "ParseBlktrace.hpp"
+
+// writetrace lines: offset size [op], byte units. The extracted Alibaba and MSR Cambridge traces only hold writes,
+// the original traces have no discard records. An optional op column marks writes (W) and discards (D).
 struct AlibabaTraceEntry {
     uint64_t ioOffset;
     uint32_t ioSize;
@@ -23,17 +27,18 @@ bool parseAlibabaTraceLine(const std::string& line, std::ofstream& out, uint64_t
     if (!(iss >> entry.ioOffset >> entry.ioSize)) {
         return false;
     }
+    std::string op;
+    iss >> op;
+    bool discard = op == "D";
+    if (!op.empty() && op != "W" && !discard) {
+        return false;
+    }
 
     uint64_t requestSize = entry.ioSize;
-    uint64_t startOffset = entry.ioOffset;
-    uint64_t endOffset = startOffset + requestSize;
-
-    histogram[requestSize]++;
-
-    for (uint64_t offset = startOffset; offset < endOffset; offset += pageSize) {
-        uint64_t pageId = offset / pageSize;
-        out << pageId << std::endl;
+    if (!discard) {
+        histogram[requestSize]++;
     }
+    writeTraceRequest(out, entry.ioOffset, requestSize, pageSize, discard);
     return true;
 }
 
@@ -79,6 +84,9 @@ void printAlibabaRequestSizeHistogram(const std::string& traceinfoFilename, cons
     }
 
     while (inFile >> trace) {
+        if (trace & traceDiscardFlag) {
+            continue;
+        }
         uniqueTraces.insert(trace);
         totalWriteRequestSize += pageSize;
         maxIOOffset = std::max(maxIOOffset, trace * pageSize);
@@ -13,6 +13,22 @@
 #include <filesystem>
 
 
+// discarded pages are written to the parsed trace with the MSB set, writes are plain page ids
+constexpr uint64_t traceDiscardFlag = uint64_t(1) << 63;
+
+// writes the pages of a request to the parsed trace, a discard only covers the pages it fully contains
+void writeTraceRequest(std::ofstream& out, uint64_t startOffset, uint64_t requestSize, uint64_t pageSize, bool discard) {
+    uint64_t endOffset = startOffset + requestSize;
+    if (discard) {
+        startOffset = (startOffset + pageSize - 1) / pageSize * pageSize;
+        endOffset = endOffset / pageSize * pageSize;
+    }
+    for (uint64_t offset = startOffset; offset < endOffset; offset += pageSize) {
+        uint64_t pageId = offset / pageSize;
+        out << (discard ? pageId | traceDiscardFlag : pageId) << std::endl;
+    }
+}
+
 struct BlkTraceEntry {
     uint64_t blockId;
     uint32_t blockCount;
@@ -28,20 +44,18 @@ bool parseBlktraceLine(const std::string& line, std::ofstream& out, uint32_t sec
         tokens.push_back(token);
     }
 
-    // Check if the line contains at least 10 tokens and the operation is a write ('W')
-    if (tokens.size() >= 10 && tokens[6] == "WS") {
+    // Check if the line contains at least 10 tokens and the operation is a write ('W') or a discard ('D')
+    bool discard = tokens.size() >= 10 && (tokens[6] == "D" || tokens[6] == "DS");
+    if (tokens.size() >= 10 && (tokens[6] == "WS" || discard)) {
         uint64_t blockId = std::stoull(tokens[7]);
         uint32_t blockCount = std::stoul(tokens[9]);
 
         uint64_t requestSize = blockCount * sectorSize;
-        histogram[requestSize]++;
-
-        uint64_t startOffset = blockId * sectorSize;
-        uint64_t endOffset = startOffset + requestSize;
-        for (uint64_t offset = startOffset; offset < endOffset; offset += pageSize) {
-            uint64_t pageId = offset / pageSize;
-            out << pageId << std::endl;
+        if (!discard) {
+            histogram[requestSize]++;
         }
+
+        writeTraceRequest(out, blockId * sectorSize, requestSize, pageSize, discard);
         return true;
     }
     return false;
@@ -78,6 +92,7 @@ void printBlktraceRequestSizeHistogram(const std::string& traceinfoFilename, con
 
     std::unordered_set<uint64_t> uniqueTraces;
     uint64_t trace;
+    uint64_t discardedPages = 0;
     uint64_t totalWriteRequestSize = 0;
     uint64_t maxIOOffset = 0;
     uint64_t minIOOffset = UINT64_MAX;
@@ -89,6 +104,10 @@ void printBlktraceRequestSizeHistogram(const std::string& traceinfoFilename, con
     }
 
     while (inFile >> trace) {
+        if (trace & traceDiscardFlag) {
+            discardedPages++;
+            continue;
+        }
         uniqueTraces.insert(trace);
         totalWriteRequestSize += pageSize;
         maxIOOffset = std::max(maxIOOffset, trace * pageSize);
@@ -102,6 +121,7 @@ void printBlktraceRequestSizeHistogram(const std::string& traceinfoFilename, con
 
     traceinfo << "Number of Unique Page IDs Accessed: " << uniqueTraces.size() << std::endl;
     traceinfo << "Total Write Request Size (page): " << totalWriteRequestSize / pageSize << " pages" << std::endl;
+    traceinfo << "Discarded (page): " << discardedPages << " pages" << std::endl;
     traceinfo << "Maximum I/O Offset (page): " << maxIOOffset / pageSize << " (GB) " << maxIOOffsetGB << " GB" << std::endl;
     traceinfo << "Minimum I/O Offset (page): " << minIOOffset / pageSize << " (GB) " << minIOOffsetGB << " GB" << std::endl;
     traceinfo << "Request Size Histogram:" << std::endl;
@@ -12,7 +12,11 @@
 #include <unordered_set>
 #include <filesystem>
 
+#include "ParseBlktrace.hpp"
 
+
+// writetrace lines: lba blocks [op], sector units. The extracted FIU traces only hold writes,
+// the original traces have no discard records. An optional op column marks writes (W) and discards (D).
 struct FIUTraceEntry {
     uint64_t lba; // logical block address (in block unit)
     uint32_t blockCnt;
@@ -29,20 +33,18 @@ bool parseFIUTraceLine(const std::string& line, std::ofstream& out, uint32_t sec
         tokens.push_back(token);
     }
 
-    if (tokens.size() == 2 && std::stoul(tokens[1]) >= 8) {
+    bool discard = tokens.size() == 3 && tokens[2] == "D";
+    bool write = tokens.size() == 2 || (tokens.size() == 3 && tokens[2] == "W");
+    if ((write || discard) && std::stoul(tokens[1]) >= 8) {
         FIUTraceEntry entry;
         entry.lba = std::stoull(tokens[0]);
         entry.blockCnt = std::stoul(tokens[1]);
 
         uint64_t requestSize = entry.blockCnt * sectorSize;
-        histogram[requestSize]++;
-
-        uint64_t startOffset = entry.lba * sectorSize;
-        uint64_t endOffset = startOffset + requestSize;
-        for (uint64_t offset = startOffset; offset < endOffset; offset += pageSize) {
-            uint64_t pageId = offset / pageSize;
-            out << pageId << std::endl;
+        if (!discard) {
+            histogram[requestSize]++;
         }
+        writeTraceRequest(out, entry.lba * sectorSize, requestSize, pageSize, discard);
         return true;
     }
     return false;
@@ -93,6 +95,9 @@ void printFIURequestSizeHistogram(const std::string& traceinfoFilename, const st
     }
 
     while (inFile >> trace) {
+        if (trace & traceDiscardFlag) {
+            continue;
+        }
         uniqueTraces.insert(trace);
         totalWriteRequestSize += pageSize;
         maxIOOffset = std::max(maxIOOffset, trace * pageSize);
@@ -4,6 +4,7 @@
 #include "ParseBlktrace.hpp"
 #include "ParseAlibabaTrace.hpp"
 #include "ParseFIUTrace.hpp"
+#include "RemapTrace.hpp"
 
 #include <vector>
 #include <string>
@@ -18,9 +19,12 @@ namespace iob {
 
 namespace fs = std::filesystem;
 
-std::string parsedTraceFile;
-size_t totalWriteCnt = 0;
-uint64_t maxPid = 0;
+// a parsed trace, per reader: several traces can be mixed in one run (mix tenants)
+struct ParsedTraceFile {
+    std::string file;         // parsed (and remapped) page trace to read
+    size_t totalWriteCnt = 0; // page writes, only known if the trace was parsed by this run
+    uint64_t maxPid = 0;
+};
 
 std::string getTraceFilePath(const std::string& patternString) {
     std::string traceFile;
@@ -34,16 +38,16 @@ std::string getTraceFilePath(const std::string& patternString) {
     return traceFile;
 }
 
-std::string getTraceParsedTraceFilePath(const std::string& patternString) {
-    return patternString + "_input_traces.txt";
+// remap: none, dense or extentN (see RemapTrace.hpp), remapped traces are kept next to the parsed one
+std::string getTraceParsedTraceFilePath(const std::string& patternString, const std::string& remap = "none") {
+    return remap == "none" ? patternString + "_input_traces.txt" : patternString + "_" + remap + "_input_traces.txt";
 }
 
 // Function to fetch pages from the parsed trace file in chunks
-// Function to fetch pages from the parsed trace file in chunks
-bool fetchPagesFromParsedTrace(std::vector<uint64_t>& inputTraces, size_t chunkSize, size_t& traceIndex) {
-    static std::ifstream inFile(parsedTraceFile);
+// every reader has its own stream (several traces can be mixed in one run)
+bool fetchPagesFromParsedTrace(std::ifstream& inFile, std::vector<uint64_t>& inputTraces, size_t chunkSize, size_t& traceIndex) {
     if (!inFile.is_open()) {
-        std::cerr << "Error: Unable to open file " << parsedTraceFile << " for reading input traces." << std::endl;
+        std::cerr << "Error: Unable to open the parsed trace file for reading input traces." << std::endl;
         return false;
     }
 
@@ -79,9 +83,10 @@ bool fetchPagesFromParsedTrace(std::vector<uint64_t>& inputTraces, size_t chunkS
 
 // Function to get a page from the parsed trace file
 // Function to get a page from the parsed trace file
-uint64_t getPageFromParsedTrace(std::vector<uint64_t>& inputTraces, size_t& traceIndex, size_t chunkSize) {
+// discards are returned with traceDiscardFlag set
+uint64_t getPageFromParsedTrace(std::ifstream& inFile, std::vector<uint64_t>& inputTraces, size_t& traceIndex, size_t chunkSize) {
     if (traceIndex % chunkSize == 0) {
-        if (!fetchPagesFromParsedTrace(inputTraces, chunkSize, traceIndex)) {
+        if (!fetchPagesFromParsedTrace(inFile, inputTraces, chunkSize, traceIndex)) {
             throw std::runtime_error("Error: Unable to fetch more pages from the parsed trace file.");
         }
     }
@@ -96,7 +101,7 @@ uint64_t getPageFromParsedTrace(std::vector<uint64_t>& inputTraces, size_t& trac
     return page;
 }
 
-void generateAccessFrequencyHistogram(const std::string& parsedTraceFile, const std::string& outputFilename, const std::string& patternString) {
+void generateAccessFrequencyHistogram(const std::string& parsedTraceFile, const std::string& outputFilename, const std::string& patternString, size_t totalWriteCnt) {
     std::string csvOutputFilename = patternString + "_access_frequency.csv";
     std::ifstream inFile(parsedTraceFile);
     if (!inFile.is_open()) {
@@ -106,6 +111,9 @@ void generateAccessFrequencyHistogram(const std::string& parsedTraceFile, const
     std::map<uint64_t, uint64_t> frequencyMap;
     uint64_t pageId;
     while (inFile >> pageId) {
+        if (pageId & traceDiscardFlag) {
+            continue;
+        }
         frequencyMap[pageId]++;
     }
     inFile.close();
@@ -180,30 +188,50 @@ void generateAccessFrequencyHistogram(const std::string& parsedTraceFile, const
 }
 
 
-void validateAndLoadTraceFiles(const std::string& tracePath, const std::string& patternString, uint32_t sectorSize, uint64_t logicalPages, uint64_t pageSize, std::vector<uint64_t>& inputTraces) {
-    parsedTraceFile = getTraceParsedTraceFilePath(patternString);
-
-    // Check if the parsed trace file exists and delete it
-    if (fs::exists(parsedTraceFile)) {
-        return;
-    }
-
-    maxPid = logicalPages;
+// accessHistogram: also writes the access frequency csv of the trace and plots it (std::map of all pages, Rscript)
+ParsedTraceFile parseTraceFile(const std::string& tracePath, const std::string& patternString, uint32_t sectorSize, uint64_t logicalPages, uint64_t pageSize, bool accessHistogram = true) {
+    ParsedTraceFile parsed;
+    parsed.file = getTraceParsedTraceFilePath(patternString);
+    parsed.maxPid = logicalPages;
 
     if (patternString.find("RocksDBYCSB") != std::string::npos || patternString.find("LeanStoreTPCC") != std::string::npos || 
         patternString.find("MySQLTPCC") != std::string::npos || patternString.find("RocksDBDBench") != std::string::npos) {
-        validateAndLoadBlkTraces(tracePath, sectorSize, logicalPages, pageSize, patternString, parsedTraceFile, &totalWriteCnt);
+        validateAndLoadBlkTraces(tracePath, sectorSize, logicalPages, pageSize, patternString, parsed.file, &parsed.totalWriteCnt);
     } else if (patternString.find("Alibaba") != std::string::npos || patternString.find("MSRCambridge") != std::string::npos) {
-        validateAndLoadAlibabaTraces(tracePath, logicalPages, pageSize, patternString, parsedTraceFile, &totalWriteCnt);
+        validateAndLoadAlibabaTraces(tracePath, logicalPages, pageSize, patternString, parsed.file, &parsed.totalWriteCnt);
     } else if (patternString.find("FIU") != std::string::npos) {
-        validateAndLoadFIUTraces(tracePath, sectorSize, logicalPages, pageSize, patternString, parsedTraceFile, &totalWriteCnt);
+        validateAndLoadFIUTraces(tracePath, sectorSize, logicalPages, pageSize, patternString, parsed.file, &parsed.totalWriteCnt);
     } else {
         throw std::runtime_error("Unsupported trace type in pattern string.");
     }
-    parsedTraceFile = getTraceParsedTraceFilePath(patternString);
-    std::cout << "Parsed trace file: " << parsedTraceFile << std::endl;
-    std::string csvFile = patternString + "access_frequency.csv";
-    generateAccessFrequencyHistogram(parsedTraceFile, csvFile, patternString);
+    std::cout << "Parsed trace file: " << parsed.file << std::endl;
+    if (accessHistogram) {
+        std::string csvFile = patternString + "access_frequency.csv";
+        generateAccessFrequencyHistogram(parsed.file, csvFile, patternString, parsed.totalWriteCnt);
+    }
+    return parsed;
+}
+
+// parses the trace (once) and renumbers its pages (once per remap), the file of the result is the one to read
+// accessHistogram = false: parse only, e.g. for tools that characterize the trace themselves
+ParsedTraceFile validateAndLoadTraceFiles(const std::string& tracePath, const std::string& patternString, uint32_t sectorSize, uint64_t logicalPages, uint64_t pageSize, std::vector<uint64_t>& inputTraces, const std::string& remap = "none", bool accessHistogram = true) {
+    ParsedTraceFile parsed;
+    parsed.maxPid = logicalPages;
+    std::string remappedTraceFile = getTraceParsedTraceFilePath(patternString, remap);
+    if (fs::exists(remappedTraceFile)) {
+        parsed.file = remappedTraceFile;
+        return parsed;
+    }
+    parsed.file = getTraceParsedTraceFilePath(patternString);
+    if (!fs::exists(parsed.file)) {
+        parsed = parseTraceFile(tracePath, patternString, sectorSize, logicalPages, pageSize, accessHistogram);
+    }
+    if (remap != "none") {
+        std::cout << "Remapping trace pages (" << remap << "): " << remappedTraceFile << std::endl;
+        printTraceFootprint(remapParsedTrace(parsed.file, remappedTraceFile, remap), pageSize);
+        parsed.file = remappedTraceFile;
+    }
+    return parsed;
 }
 
 } // namespace iob
@@ -0,0 +1,185 @@
+#ifndef REMAP_TRACE_HPP
+#define REMAP_TRACE_HPP
+
+#include "ParseBlktrace.hpp"
+
+#include <array>
+#include <bit>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+// Renumbering of the pages of a parsed trace (one page id per line, discards flagged with traceDiscardFlag).
+// Traces of large volumes touch few sparse regions, renumbering them densely lets the simulated
+// capacity match the footprint of the trace instead of its address range.
+//   none:    page ids are kept
+//   dense:   written pages are numbered in first write order [0, touched pages)
+//   extentN: extents of N pages with writes are numbered in address order, the offset within an extent
+//            is kept (locality preserving, e.g. extent256 keeps 1M regions with 4K pages)
+// Two streaming passes over the parsed trace, the first builds the hash map of touched pages (dense) or extents,
+// the second writes the renumbered trace. Discards of pages without writes are dropped.
+
+struct TraceFootprint {
+    uint64_t touchedPages = 0; // distinct written pages
+    uint64_t addressRange = 0; // largest written page + 1 (after remapping)
+    uint64_t originalRange = 0; // largest written page + 1 of the trace
+    uint64_t writes = 0;
+    uint64_t discards = 0;
+};
+
+std::string traceFootprintPath(const std::string& parsedTraceFile) {
+    return parsedTraceFile + ".footprint";
+}
+
+void writeTraceFootprint(const std::string& parsedTraceFile, const TraceFootprint& f) {
+    std::ofstream out(traceFootprintPath(parsedTraceFile));
+    out << f.touchedPages << " " << f.addressRange << " " << f.originalRange << " " << f.writes << " " << f.discards << std::endl;
+}
+
+void printTraceFootprint(const TraceFootprint& f, uint64_t pageSize) {
+    double gb = 1024.0 * 1024 * 1024;
+    std::cout << "Trace footprint: " << f.touchedPages << " pages (" << f.touchedPages * pageSize / gb << " GB)"
+              << " address range: " << f.originalRange << " pages (" << f.originalRange * pageSize / gb << " GB)"
+              << " density: " << (f.originalRange ? (double)f.touchedPages / f.originalRange : 0)
+              << " remapped range: " << f.addressRange << " pages"
+              << " writes: " << f.writes << " discards: " << f.discards << std::endl;
+}
+
+uint64_t parseRemapExtent(const std::string& remap) {
+    if (remap == "none" || remap == "dense") {
+        return 0;
+    }
+    if (remap.starts_with("extent")) {
+        uint64_t extent = std::stoull(remap.substr(6));
+        if (extent > 0) {
+            return extent;
+        }
+    }
+    throw std::runtime_error("Unknown trace remap: " + remap + " (none, dense, extentN)");
+}
+
+// set of touched pages, a bitmap per chunk of 4096 pages with writes (1 bit per page instead of a hash map entry)
+class TouchedPages {
+    static constexpr uint64_t chunkPages = 4096;
+    std::unordered_map<uint64_t, std::array<uint64_t, chunkPages / 64>> chunks;
+
+public:
+    void add(uint64_t page) {
+        auto& bits = chunks[page / chunkPages];
+        uint64_t idx = page % chunkPages;
+        bits[idx / 64] |= 1ULL << (idx % 64);
+    }
+
+    uint64_t count() const {
+        uint64_t c = 0;
+        for (auto& [chunk, bits]: chunks) {
+            for (uint64_t word: bits) {
+                c += std::popcount(word);
+            }
+        }
+        return c;
+    }
+};
+
+// first pass: touched pages of the trace, renumbering of written pages (dense) or extents
+TraceFootprint collectTracePages(const std::string& parsedTraceFile, const std::string& remap, std::unordered_map<uint64_t, uint64_t>& ids) {
+    uint64_t extent = parseRemapExtent(remap);
+    bool dense = remap == "dense";
+    std::ifstream in(parsedTraceFile);
+    if (!in.is_open()) {
+        throw std::runtime_error("Error: Unable to open file " + parsedTraceFile + " for remapping.");
+    }
+    TraceFootprint f;
+    TouchedPages touched; // none and extentN only need the count
+    uint64_t page;
+    while (in >> page) {
+        if (page & traceDiscardFlag) {
+            f.discards++;
+            continue;
+        }
+        f.writes++;
+        f.originalRange = std::max(f.originalRange, page + 1);
+        if (dense) {
+            ids.try_emplace(page, ids.size());
+            continue;
+        }
+        touched.add(page);
+        if (extent > 0) {
+            ids.try_emplace(page / extent, 0);
+        }
+    }
+    if (dense) {
+        f.touchedPages = ids.size();
+        f.addressRange = f.touchedPages;
+        return f;
+    }
+    f.touchedPages = touched.count();
+    if (extent > 0) {
+        std::vector<uint64_t> extents;
+        extents.reserve(ids.size());
+        for (auto& [e, rank]: ids) {
+            extents.push_back(e);
+        }
+        std::sort(extents.begin(), extents.end());
+        for (uint64_t i = 0; i < extents.size(); i++) {
+            ids[extents[i]] = i;
+        }
+        f.addressRange = extents.size() * extent;
+    } else {
+        f.addressRange = f.originalRange;
+    }
+    return f;
+}
+
+// second pass: writes the renumbered trace to remappedTraceFile
+void writeRemappedTrace(const std::string& parsedTraceFile, const std::string& remappedTraceFile, const std::string& remap, const std::unordered_map<uint64_t, uint64_t>& ids) {
+    uint64_t extent = parseRemapExtent(remap);
+    std::ifstream in(parsedTraceFile);
+    std::string tmpFile = remappedTraceFile + ".tmp";
+    std::ofstream out(tmpFile);
+    if (!in.is_open() || !out.is_open()) {
+        throw std::runtime_error("Error: Unable to remap " + parsedTraceFile);
+    }
+    uint64_t page;
+    while (in >> page) {
+        uint64_t flag = page & traceDiscardFlag;
+        page &= ~traceDiscardFlag;
+        auto it = ids.find(extent > 0 ? page / extent : page);
+        if (it == ids.end()) {
+            continue; // discard of a page without writes
+        }
+        uint64_t mapped = extent > 0 ? it->second * extent + page % extent : it->second;
+        out << (mapped | flag) << "\n";
+    }
+    out.close();
+    // the remapped trace only appears once it is complete
+    std::filesystem::rename(tmpFile, remappedTraceFile);
+}
+
+// remaps parsedTraceFile into remappedTraceFile (none: only the footprint is computed)
+TraceFootprint remapParsedTrace(const std::string& parsedTraceFile, const std::string& remappedTraceFile, const std::string& remap) {
+    std::unordered_map<uint64_t, uint64_t> ids;
+    TraceFootprint f = collectTracePages(parsedTraceFile, remap, ids);
+    if (remap != "none") {
+        writeRemappedTrace(parsedTraceFile, remappedTraceFile, remap, ids);
+    }
+    writeTraceFootprint(remappedTraceFile, f);
+    return f;
+}
+
+// footprint of a (remapped) parsed trace, computed on first use
+TraceFootprint readTraceFootprint(const std::string& parsedTraceFile) {
+    TraceFootprint f;
+    std::ifstream in(traceFootprintPath(parsedTraceFile));
+    if (!(in >> f.touchedPages >> f.addressRange >> f.originalRange >> f.writes >> f.discards)) {
+        f = remapParsedTrace(parsedTraceFile, parsedTraceFile, "none");
+    }
+    return f;
+}
+
+#endif // REMAP_TRACE_HPP
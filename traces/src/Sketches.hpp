@@ -0,0 +1,171 @@
+#ifndef SKETCHES_HPP
+#define SKETCHES_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Mergeable streaming summaries of page access streams with bounded memory, used by wlstat.
+// Every summary has merge() so chunks of a trace can be summarized by separate threads.
+
+inline uint64_t sketchHash(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// HyperLogLog distinct count, 2^p one byte registers, standard error ~1.04 / sqrt(2^p)
+class HyperLogLog {
+    uint32_t p;
+    std::vector<uint8_t> registers;
+
+public:
+    explicit HyperLogLog(uint32_t p = 14) : p(p), registers(1ULL << p, 0) {}
+
+    void add(uint64_t key) {
+        uint64_t h = sketchHash(key);
+        uint64_t idx = h >> (64 - p);
+        uint8_t rank = std::countl_zero((h << p) | (1ULL << (p - 1))) + 1;
+        registers[idx] = std::max(registers[idx], rank);
+    }
+
+    void merge(const HyperLogLog& other) {
+        for (size_t i = 0; i < registers.size(); i++) {
+            registers[i] = std::max(registers[i], other.registers[i]);
+        }
+    }
+
+    double estimate() const {
+        double m = registers.size();
+        double sum = 0;
+        uint64_t zeros = 0;
+        for (uint8_t r: registers) {
+            sum += std::ldexp(1.0, -r);
+            zeros += r == 0;
+        }
+        double alpha = 0.7213 / (1 + 1.079 / m);
+        double e = alpha * m * m / sum;
+        if (e <= 2.5 * m && zeros > 0) {
+            e = m * std::log(m / zeros); // linear counting for small cardinalities
+        }
+        return e;
+    }
+};
+
+// Count-Min sketch, estimates never undercount, overcount <= e / width * total with probability 1 - e^-depth
+class CountMin {
+    uint64_t width;
+    uint32_t depth;
+    std::vector<uint32_t> counters;
+
+    uint64_t slot(uint32_t row, uint64_t key) const {
+        return row * width + (sketchHash(key ^ (0x5bd1e995ULL * (row + 1))) & (width - 1));
+    }
+
+public:
+    CountMin(uint64_t widthPow2 = 1 << 20, uint32_t depth = 4) : width(widthPow2), depth(depth), counters(widthPow2 * depth, 0) {}
+
+    // returns the new estimate of key
+    uint32_t add(uint64_t key) {
+        uint32_t est = ~0U;
+        for (uint32_t r = 0; r < depth; r++) {
+            uint32_t& c = counters[slot(r, key)];
+            c++;
+            est = std::min(est, c);
+        }
+        return est;
+    }
+
+    uint32_t estimate(uint64_t key) const {
+        uint32_t est = ~0U;
+        for (uint32_t r = 0; r < depth; r++) {
+            est = std::min(est, counters[slot(r, key)]);
+        }
+        return est;
+    }
+
+    void merge(const CountMin& other) {
+        for (size_t i = 0; i < counters.size(); i++) {
+            counters[i] += other.counters[i];
+        }
+    }
+};
+
+// top k keys by their count-min estimate, a key enters once its estimate exceeds the smallest tracked count
+class HeavyHitters {
+    size_t k;
+    std::unordered_map<uint64_t, uint32_t> counts;
+    std::set<std::pair<uint32_t, uint64_t>> ordered; // count, key
+
+public:
+    explicit HeavyHitters(size_t k = 100) : k(k) {}
+
+    void offer(uint64_t key, uint32_t estimate) {
+        auto it = counts.find(key);
+        if (it != counts.end()) {
+            ordered.erase({it->second, key});
+            it->second = estimate;
+            ordered.emplace(estimate, key);
+            return;
+        }
+        if (counts.size() < k) {
+            counts.emplace(key, estimate);
+            ordered.emplace(estimate, key);
+        } else if (estimate > ordered.begin()->first) {
+            counts.erase(ordered.begin()->second);
+            ordered.erase(ordered.begin());
+            counts.emplace(key, estimate);
+            ordered.emplace(estimate, key);
+        }
+    }
+
+    std::vector<uint64_t> keys() const {
+        std::vector<uint64_t> ret;
+        for (auto& [key, c]: counts) {
+            ret.push_back(key);
+        }
+        return ret;
+    }
+};
+
+// power of two bins: bin 0 holds 0, bin i holds [2^(i-1), 2^i)
+class Log2Hist {
+    std::vector<uint64_t> bins = std::vector<uint64_t>(65, 0);
+
+public:
+    void add(uint64_t v, uint64_t cnt = 1) { bins[std::bit_width(v)] += cnt; }
+    void merge(const Log2Hist& other) {
+        for (size_t i = 0; i < bins.size(); i++) {
+            bins[i] += other.bins[i];
+        }
+    }
+    const std::vector<uint64_t>& counts() const { return bins; }
+    uint64_t total() const {
+        uint64_t t = 0;
+        for (uint64_t b: bins) {
+            t += b;
+        }
+        return t;
+    }
+    static uint64_t lower(size_t bin) { return bin == 0 ? 0 : 1ULL << (bin - 1); }
+    // upper bound of the bin that contains the q quantile
+    uint64_t quantile(double q) const {
+        uint64_t t = total();
+        uint64_t sum = 0;
+        for (size_t i = 0; i < bins.size(); i++) {
+            sum += bins[i];
+            if (sum > 0 && sum >= q * t) {
+                return i == 0 ? 0 : (i == 64 ? ~0ULL : (1ULL << i) - 1);
+            }
+        }
+        return 0;
+    }
+};
+
+#endif // SKETCHES_HPP
@@ -0,0 +1,328 @@
+// streaming workload characterization of a parsed trace or a synthetic pattern:
+// unique pages, skew curve, update intervals, sequentiality and the hottest pages
+// output: csv lines prefixed with "wlstat," (grep them, other output is informational)
+//
+// Memory is bounded: unique pages by HyperLogLog, hot pages by Count-Min + top k,
+// the skew curve and the update intervals by a hash sample of the pages (--sample).
+// Parsed traces are split into one chunk per thread, chunk summaries are merged in trace order.
+#include "PatternGen.hpp" // includes the trace readers, RejectionInversionZipf.hpp has no include guard
+#include "Seed.hpp"
+#include "src/Sketches.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using iob::PatternGen;
+using std::cout;
+using std::endl;
+using std::string;
+
+struct StatOptions {
+    string file;
+    uint64_t threads;
+    double sample;
+    uint32_t hllP;
+    uint64_t cmsWidth;
+    uint64_t top;
+    string capacityStr;
+    string pageStr;
+    uint64_t seed;
+};
+
+// summary of a consecutive part of the access stream
+struct ChunkStats {
+    struct Sampled {
+        uint64_t count;
+        uint64_t first; // write index in the chunk
+        uint64_t last;
+    };
+    uint64_t writes = 0;
+    uint64_t discards = 0;
+    uint64_t addressRange = 0;
+    uint64_t seqWrites = 0; // page == previous page + 1
+    uint64_t firstPage = 0;
+    uint64_t lastPage = 0;
+    uint64_t run = 0;
+    Log2Hist runLengths; // runs that cross a chunk border are counted as two
+    HyperLogLog hll;
+    CountMin cms;
+    HeavyHitters hot;
+    uint64_t sampleThreshold;
+    std::unordered_map<uint64_t, Sampled> sampled;
+    Log2Hist intervals; // writes between two writes of a sampled page
+
+    explicit ChunkStats(const StatOptions& o)
+        : hll(o.hllP), cms(o.cmsWidth), hot(o.top), sampleThreshold(o.sample >= 1 ? ~0ULL : o.sample * 0x1p64) {}
+
+    static bool isSampled(uint64_t page, uint64_t threshold) { return sketchHash(page ^ 0x2545f4914f6cdd1dULL) <= threshold; }
+
+    void write(uint64_t page) {
+        if (writes > 0 && page == lastPage + 1) {
+            seqWrites++;
+            run++;
+        } else {
+            if (writes == 0) {
+                firstPage = page;
+            } else {
+                runLengths.add(run);
+            }
+            run = 1;
+        }
+        lastPage = page;
+        addressRange = std::max(addressRange, page + 1);
+        hll.add(page);
+        hot.offer(page, cms.add(page));
+        if (isSampled(page, sampleThreshold)) {
+            auto [it, inserted] = sampled.try_emplace(page, Sampled{0, writes, writes});
+            if (!inserted) {
+                intervals.add(writes - it->second.last);
+                it->second.last = writes;
+            }
+            it->second.count++;
+        }
+        writes++;
+    }
+
+    void access(uint64_t page) {
+        if (page & traceDiscardFlag) {
+            discards++;
+        } else {
+            write(page);
+        }
+    }
+
+    void finish() {
+        if (run > 0) {
+            runLengths.add(run);
+            run = 0;
+        }
+    }
+
+    // appends the chunk that follows this one in the stream
+    void append(ChunkStats& next, std::vector<uint64_t>& hotCandidates) {
+        if (next.writes > 0 && writes > 0 && next.firstPage == lastPage + 1) {
+            seqWrites++;
+        }
+        uint64_t offset = writes;
+        for (auto& [page, s]: next.sampled) {
+            auto [it, inserted] = sampled.try_emplace(page, Sampled{s.count, offset + s.first, offset + s.last});
+            if (!inserted) {
+                intervals.add(offset + s.first - it->second.last);
+                it->second.count += s.count;
+                it->second.last = offset + s.last;
+            }
+        }
+        if (next.writes > 0) {
+            lastPage = next.lastPage;
+            if (writes == 0) {
+                firstPage = next.firstPage;
+            }
+        }
+        writes += next.writes;
+        discards += next.discards;
+        seqWrites += next.seqWrites;
+        addressRange = std::max(addressRange, next.addressRange);
+        runLengths.merge(next.runLengths);
+        hll.merge(next.hll);
+        cms.merge(next.cms);
+        intervals.merge(next.intervals);
+        auto keys = next.hot.keys();
+        hotCandidates.insert(hotCandidates.end(), keys.begin(), keys.end());
+    }
+};
+
+// lines starting in [begin, end) of a parsed trace (one page id per line)
+static void scanChunk(const string& file, uint64_t begin, uint64_t end, ChunkStats& stats) {
+    std::ifstream in(file, std::ios::binary);
+    std::vector<char> buf(1 << 20);
+    uint64_t pos = begin;
+    if (begin > 0) {
+        // the line that contains begin belongs to the previous chunk
+        in.seekg(begin - 1);
+        pos = begin - 1;
+        char c;
+        while (in.get(c)) {
+            pos++;
+            if (c == '\n') {
+                break;
+            }
+        }
+    } else {
+        in.seekg(0);
+    }
+    uint64_t value = 0;
+    bool number = false;
+    bool done = pos >= end;
+    while (!done && in) {
+        in.read(buf.data(), buf.size());
+        std::streamsize n = in.gcount();
+        for (std::streamsize i = 0; i < n; i++) {
+            char c = buf[i];
+            if (c >= '0' && c <= '9') {
+                value = value * 10 + (c - '0');
+                number = true;
+            } else if (c == '\n') {
+                if (number) {
+                    stats.access(value);
+                }
+                value = 0;
+                number = false;
+                if (pos + i + 1 >= end) {
+                    done = true;
+                    break;
+                }
+            }
+        }
+        pos += n;
+    }
+    if (number && !done) {
+        stats.access(value); // last line without newline
+    }
+    stats.finish();
+}
+
+static ChunkStats scanTrace(const string& file, const StatOptions& o, std::vector<uint64_t>& hotCandidates) {
+    uint64_t size = std::filesystem::file_size(file);
+    uint64_t threads = std::max<uint64_t>(1, std::min<uint64_t>(o.threads, size / (1 << 20) + 1));
+    cout << "scanning " << file << " (" << size / (1 << 20) << " MB) with " << threads << " threads" << endl;
+    std::vector<ChunkStats> chunks;
+    chunks.reserve(threads);
+    for (uint64_t t = 0; t < threads; t++) {
+        chunks.emplace_back(o);
+    }
+    std::vector<std::thread> workers;
+    for (uint64_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() { scanChunk(file, size * t / threads, size * (t + 1) / threads, chunks[t]); });
+    }
+    for (auto& w: workers) {
+        w.join();
+    }
+    auto keys = chunks[0].hot.keys();
+    hotCandidates.insert(hotCandidates.end(), keys.begin(), keys.end());
+    for (uint64_t t = 1; t < threads; t++) {
+        chunks[0].append(chunks[t], hotCandidates);
+    }
+    return std::move(chunks[0]);
+}
+
+// synthetic patterns are generated in order by a single generator
+static ChunkStats scanPattern(PatternGen::Options& pgOptions, const StatOptions& o, std::vector<uint64_t>& hotCandidates) {
+    PatternGen pg(pgOptions);
+    pg.emitDiscards = true;
+    std::mt19937_64 rng = Seed(o.seed).split(1).rng();
+    uint64_t accesses = pgOptions.writesInDiskOverwrites * pgOptions.logicalPages;
+    cout << "generating " << accesses << " accesses of " << pgOptions.patternString << endl;
+    ChunkStats stats(o);
+    for (uint64_t i = 0; i < accesses; i++) {
+        uint64_t page = pg.accessPatternGenerator(rng);
+        for (auto [first, count]: pg.discards) {
+            stats.discards += count;
+        }
+        pg.discards.clear();
+        stats.write(page);
+    }
+    stats.finish();
+    hotCandidates = stats.hot.keys();
+    return stats;
+}
+
+static void report(const string& kind, const string& key, const string& value) {
+    cout << std::format("wlstat,{},{},{}", kind, key, value) << endl;
+}
+
+static void printStats(const ChunkStats& s, std::vector<uint64_t>& hotCandidates, const StatOptions& o, uint64_t pageSize) {
+    double unique = s.hll.estimate();
+    cout << "wlstat,kind,key,value" << endl;
+    report("summary", "writes", std::to_string(s.writes));
+    report("summary", "discards", std::to_string(s.discards));
+    report("summary", "uniquepages", std::format("{:.0f}", unique));
+    report("summary", "uniquegb", std::format("{:.3f}", unique * pageSize / (1024.0 * 1024 * 1024)));
+    report("summary", "addressrange", std::to_string(s.addressRange));
+    report("summary", "density", std::format("{:.6f}", s.addressRange ? unique / s.addressRange : 0));
+    report("summary", "writesperpage", std::format("{:.3f}", unique > 0 ? s.writes / unique : 0));
+    report("summary", "seqfraction", std::format("{:.5f}", s.writes ? (double)s.seqWrites / s.writes : 0));
+    report("summary", "runp50", std::to_string(s.runLengths.quantile(0.5)));
+    report("summary", "runp99", std::to_string(s.runLengths.quantile(0.99)));
+    // skew: share of the writes that go to the hottest x% of the (sampled) pages
+    std::vector<uint64_t> counts;
+    counts.reserve(s.sampled.size());
+    uint64_t sampledWrites = 0;
+    for (auto& [page, sp]: s.sampled) {
+        counts.push_back(sp.count);
+        sampledWrites += sp.count;
+    }
+    std::sort(counts.begin(), counts.end(), std::greater<>());
+    report("summary", "sampledpages", std::to_string(counts.size()));
+    for (double top: {0.001, 0.01, 0.05, 0.1, 0.2, 0.5, 0.8}) {
+        uint64_t n = std::ceil(top * counts.size());
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n && i < counts.size(); i++) {
+            sum += counts[i];
+        }
+        report("skew", std::format("{}", top), std::format("{:.5f}", sampledWrites ? (double)sum / sampledWrites : 0));
+    }
+    // update intervals in writes, power of two bins by lower bound
+    for (double q: {0.1, 0.5, 0.9, 0.99}) {
+        report("intervalq", std::format("{}", q), std::to_string(s.intervals.quantile(q)));
+    }
+    for (size_t b = 0; b < s.intervals.counts().size(); b++) {
+        if (s.intervals.counts()[b] > 0) {
+            report("interval", std::to_string(Log2Hist::lower(b)), std::to_string(s.intervals.counts()[b]));
+        }
+    }
+    // hottest pages by their count-min estimate
+    std::sort(hotCandidates.begin(), hotCandidates.end());
+    hotCandidates.erase(std::unique(hotCandidates.begin(), hotCandidates.end()), hotCandidates.end());
+    std::vector<std::pair<uint32_t, uint64_t>> hot;
+    for (uint64_t page: hotCandidates) {
+        hot.emplace_back(s.cms.estimate(page), page);
+    }
+    std::sort(hot.begin(), hot.end(), std::greater<>());
+    hot.resize(std::min<size_t>(hot.size(), o.top));
+    for (auto& [est, page]: hot) {
+        report("hot", std::to_string(page), std::to_string(est));
+    }
+}
+
+int main(int argc, char** argv) {
+    CLI::App app{"Workload characterization"};
+    StatOptions o;
+    app.add_option("--file", o.file, "Parsed trace (one page per line), otherwise --pattern is used (trace patterns are parsed first)")->default_val("");
+    app.add_option("--threads", o.threads, "Threads for parsed traces")->default_val(std::max(1U, std::thread::hardware_concurrency()));
+    app.add_option("--sample", o.sample, "Fraction of the pages (by hash) tracked exactly for the skew curve and update intervals")->default_val(0.01);
+    app.add_option("--hll-p", o.hllP, "HyperLogLog precision, 2^p registers")->check(CLI::Range(4, 18))->default_val(14);
+    app.add_option("--cms-width", o.cmsWidth, "Count-Min width (power of two), 4 rows per thread")->default_val(1 << 20);
+    app.add_option("--top", o.top, "Number of hot pages to report")->default_val(10);
+    app.add_option("--capacity", o.capacityStr, "Logical capacity of synthetic patterns")->default_val("16G");
+    app.add_option("--page", o.pageStr, "Page size")->default_val("4K");
+    app.add_option("--seed", o.seed, "Seed of synthetic patterns (0: random)")->default_val(0);
+    std::unique_ptr<PatternGen::Options> pgOptions = PatternGen::setupCliOptions(app);
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError& e) {
+        std::exit(app.exit(e));
+    }
+    ensurem(std::has_single_bit(o.cmsWidth), "--cms-width has to be a power of two");
+    uint64_t pageSize = getBytesFromString(o.pageStr);
+    PatternGen::cliOptionsParsed(*pgOptions, getBytesFromString(o.capacityStr) / pageSize, pageSize);
+    pgOptions->seed = Seed(o.seed).value;
+
+    std::vector<uint64_t> hotCandidates;
+    string file = o.file;
+    if (file.empty() && PatternGen::stringToPattern(pgOptions->patternString) == PatternGen::Pattern::Traces) {
+        // parse only, the streaming pass replaces the access frequency histogram (std::map of all pages)
+        std::vector<uint64_t> unused;
+        file = iob::validateAndLoadTraceFiles(iob::getTraceFilePath(pgOptions->patternString), pgOptions->patternString, pgOptions->sectorSize, pgOptions->logicalPages, pageSize, unused, pgOptions->traceRemap, false).file;
+    }
+    ChunkStats stats = file.empty() ? scanPattern(*pgOptions, o, hotCandidates) : scanTrace(file, o, hotCandidates);
+    printStats(stats, hotCandidates, o, pageSize);
+    return 0;
+}